@@ -0,0 +1,42 @@
+#ifndef BCHCODES_INCLUDE_ADDITIVEFFT_H_
+#define BCHCODES_INCLUDE_ADDITIVEFFT_H_
+
+#include <cstdint>
+#include "GF.h"
+
+class AdditiveFFT {
+    /*
+     * Gao-Mateer additive FFT: evaluates a polynomial over GF(2^m) at all 2^m
+     * field elements in O(2^m log^2(len)) additions and O(2^m log(len))
+     * multiplications, len being the padded length of the polynomial. The
+     * points are spanned by the polynomial basis 1, x, ..., x^(m-1), so
+     * values[x] is the value at the element x. The plan keeps the scaling
+     * factors and the subspace points of every recursion level; it is
+     * read-only after construction and can be shared between threads,
+     * each thread passing its own scratch.
+     */
+private:
+    uint64_t deg; // m
+    uint64_t num; // Number of non-zero field elements
+    uint64_t points; // 2^m
+    uint64_t* exps; // exps[i] = alpha^i for i < 2*num
+    uint64_t* lg; // lg[x] = i such that alpha^i = x, lg[0] = num
+    uint64_t* scale; // Log of beta^i at every level, beta being the last basis element of the level
+    uint64_t* twist; // Log of the subspace points of every level, num for zero
+    uint64_t* scale_offset; // Start of every level in scale
+    uint64_t* twist_offset; // Start of every level in twist
+    uint64_t mul_lg(uint64_t a, uint64_t b_lg) const;
+    void evaluate_level(uint64_t* f, uint64_t len, uint64_t level, uint64_t* values, uint64_t* scratch) const;
+    void interpolate_level(uint64_t* values, uint64_t level, uint64_t* scratch) const;
+public:
+    AdditiveFFT(const GF2& field);
+    AdditiveFFT(const AdditiveFFT& x) = delete;
+    AdditiveFFT& operator=(const AdditiveFFT& x) = delete;
+    ~AdditiveFFT();
+    void evaluate(uint64_t* coeffs, uint64_t len, uint64_t* values, uint64_t* scratch) const;
+    void evaluate(const GF2X& f, uint64_t* values) const;
+    void interpolate(uint64_t* values, uint64_t* scratch) const;
+    uint64_t get_points() const;
+};
+
+#endif //BCHCODES_INCLUDE_ADDITIVEFFT_H_
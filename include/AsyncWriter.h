@@ -0,0 +1,79 @@
+#ifndef BCHCODES_INCLUDE_ASYNCWRITER_H_
+#define BCHCODES_INCLUDE_ASYNCWRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include "BitMatrix.h"
+
+class AsyncWriter {
+    /*
+     * Pipelined text output of matrices. The producer hands text and packed rows
+     * over a bounded single-producer/single-consumer ring of slots; a writer
+     * thread formats rows as "b b ... b \n" and writes them, so the computation
+     * of later rows overlaps with the output of earlier ones. head and tail are
+     * atomics and handing over a slot takes no lock: the mutex is only taken by
+     * a side that finds the ring full or empty and sleeps on a condition
+     * variable, and by the other side when it has to wake it. The sink is an
+     * ostream or a file descriptor; files can be opened with O_DIRECT, then
+     * whole aligned blocks bypass the page cache and the tail is written
+     * normally at the end. A writer built with threaded = false formats
+     * straight from the caller's rows with no thread and no copy, for output
+     * that is only ready once everything is computed.
+     */
+private:
+    struct Slot {
+        std::string text; // Written before the rows
+        uint64_t* words; // Packed rows one after another
+        uint64_t capacity; // Number of allocated words
+        uint64_t rows;
+        uint64_t cols;
+    };
+    std::ostream* output; // Sink if not nullptr
+    int fd; // Sink otherwise
+    bool own_fd; // fd was opened here
+    bool direct; // fd is opened with O_DIRECT
+    bool failed; // A write failed, later output is dropped
+    bool threaded; // Rows are formatted on the writer thread
+    bool finished; // finish() has run
+    Slot* slots; // Ring of slot_count slots
+    uint64_t slot_count;
+    uint64_t slot_words; // Preferred number of words in a slot
+    std::atomic<uint64_t> head; // Slots published by the producer
+    std::atomic<uint64_t> tail; // Slots released by the writer
+    std::atomic<bool> done; // No more slots will be published
+    std::atomic<bool> producer_waiting; // The producer sleeps on space
+    std::atomic<bool> writer_waiting; // The writer sleeps on data
+    std::mutex lock; // Taken only to sleep and to wake a sleeping side
+    std::condition_variable space; // Signalled when the writer releases a slot
+    std::condition_variable data; // Signalled when a slot is published or done is set
+    char* stage; // Aligned buffer of formatted text
+    uint64_t stage_size;
+    uint64_t stage_used;
+    std::thread writer;
+    void init(uint64_t slot_count, uint64_t slot_words);
+    Slot& acquire();
+    void publish();
+    void run();
+    void put(const char* data, uint64_t size);
+    void format(const uint64_t* packed, uint64_t rows, uint64_t cols);
+    void flush_stage(bool last);
+public:
+    AsyncWriter(std::ostream& output, bool threaded = true, uint64_t slot_count = 8, uint64_t slot_words = 1 << 16);
+    AsyncWriter(int fd, bool threaded = true, uint64_t slot_count = 8, uint64_t slot_words = 1 << 16);
+    AsyncWriter(const char* path, bool direct, bool threaded = true, uint64_t slot_count = 8,
+                uint64_t slot_words = 1 << 16);
+    AsyncWriter(const AsyncWriter& x) = delete;
+    AsyncWriter& operator=(const AsyncWriter& x) = delete;
+    ~AsyncWriter();
+    void text(const std::string& s);
+    void rows(const uint64_t* packed, uint64_t rows, uint64_t cols);
+    void rows(const BitMatrix& a);
+    bool finish();
+};
+
+#endif //BCHCODES_INCLUDE_ASYNCWRITER_H_
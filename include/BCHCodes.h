@@ -2,9 +2,27 @@
 #define BCHCODES_BCHCODES_H
 
 #include <cstdint>
-
+#include <ostream>
+#include <vector>
+#include <functional>
+#include "BitMatrix.h"
+#include "CyclicMatrix.h"
 
 void build_bch_matrices(uint64_t n, uint64_t d, std::ostream& output);
-void build_bch_matrices_bit_order(uint64_t n, uint64_t d, std::ostream& output);
+// Builders verify their output unless verify is false and return false if it fails:
+// all of them check G H^T = 0, systematic ones first check that g(x) divides x^n + 1.
+// The printing builders write nothing for a code failing the verification.
+bool build_bch_matrices_bit_order(uint64_t n, uint64_t d, std::ostream& output);
+bool bch_matrices_bit_order(uint64_t n, uint64_t d, BitMatrix& g, BitMatrix& h, unsigned threads = 0, bool verify = true);
+bool build_bch_matrices_systematic(uint64_t n, uint64_t d, bool extended, std::ostream& output);
+bool bch_matrices_systematic(uint64_t n, uint64_t d, bool extended, BitMatrix& g, BitMatrix& h, bool verify = true,
+                             unsigned threads = 0);
+bool cyclic_matrices_systematic(uint64_t n, const std::vector<uint64_t>& gen, bool extended, BitMatrix& g, BitMatrix& h,
+                                bool verify = true, unsigned threads = 0);
+bool bch_sweep_systematic(uint64_t n, bool extended, std::vector<uint64_t>& gen, BitMatrix& g, BitMatrix& h,
+                          const std::function<void(uint64_t)>& emit, bool verify = true, unsigned threads = 0);
+std::vector<uint64_t> bch_generator_poly(uint64_t n, uint64_t d);
+void cyclic_matrix_views(uint64_t n, const std::vector<uint64_t>& gen, CyclicMatrix& g, CyclicMatrix& h);
+void bch_matrix_views(uint64_t n, uint64_t d, CyclicMatrix& g, CyclicMatrix& h);
 
 #endif
@@ -0,0 +1,114 @@
+#ifndef BCHCODES_INCLUDE_BCHDECODER_H_
+#define BCHCODES_INCLUDE_BCHDECODER_H_
+
+#include <cstdint>
+#include "GF.h"
+#include "AdditiveFFT.h"
+
+struct BCHWorkspace {
+    /*
+     * Scratch of the algebraic decoder. Every thread decoding with the same
+     * BCHDecoder needs its own workspace.
+     */
+    uint64_t t;
+    uint64_t* syn;
+    uint64_t* errors;
+    uint64_t* lambda;
+    uint64_t* b;
+    uint64_t* tmp;
+    uint64_t* reg;
+    uint64_t* fft_coeffs; // Additive FFT buffers of 2^m elements, nullptr if the decoder evaluates directly
+    uint64_t* fft_values;
+    uint64_t* fft_scratch;
+    BCHWorkspace(uint64_t t, uint64_t points = 0);
+    BCHWorkspace(const BCHWorkspace& x) = delete;
+    BCHWorkspace& operator=(const BCHWorkspace& x) = delete;
+    ~BCHWorkspace();
+    void resize(uint64_t t, uint64_t points = 0);
+    void release();
+};
+
+class BCHDecoder {
+    /*
+     * Algebraic decoder for binary narrow-sense BCH codes of length n = 2^m - 1
+     * and designed distance d. Words are given as one bit per byte. Two layouts:
+     * cyclic    - position i has locator alpha^i, as in build_bch_matrices;
+     * bit order - extended code of length n+1 where position i has locator i
+     *             taken as a field element and position 0 is the overall
+     *             parity, as in build_bch_matrices_bit_order.
+     * set_distance switches to another distance of the same length in place.
+     * t changes with it, so workspaces and syndrome buffers sized from get_t()
+     * must be resized and other decoders built on this one rebuilt;
+     * ChaseDecoder follows the change by itself.
+     */
+private:
+    GF2 field; // Field of the locators
+    uint64_t len; // Length of a word
+    uint64_t num; // Number of non-zero field elements
+    uint64_t t; // Number of correctable errors
+    bool bit_order; // Layout of the positions
+    uint64_t* exps; // exps[i] = alpha^i
+    uint64_t* lg; // lg[x] = i such that alpha^i = x, lg[0] = num
+    uint64_t* logs; // logs[p] = log of the locator of position p, num for the zero locator
+    uint64_t* positions; // positions[i] = position with locator alpha^i
+    AdditiveFFT* fft; // Multipoint evaluation for large t, nullptr if never needed
+    bool fft_chien; // Chien search goes through the FFT for the current t
+    bool fft_syndromes; // Syndromes of cyclic words are taken from the FFT of the word
+    BCHWorkspace work; // Scratch for decode()
+    uint64_t mul(uint64_t a, uint64_t b) const;
+public:
+    BCHDecoder(uint64_t n, uint64_t d, bool bit_order = false);
+    BCHDecoder(const BCHDecoder& x) = delete;
+    BCHDecoder& operator=(const BCHDecoder& x) = delete;
+    ~BCHDecoder();
+    void set_distance(uint64_t d);
+    void syndromes(const uint8_t* word, uint64_t* syn) const;
+    void syndromes(const uint8_t* word, uint64_t* syn, BCHWorkspace& w) const;
+    void flip_syndromes(uint64_t pos, uint64_t* syn) const;
+    int decode_syndromes(const uint64_t* syn, BCHWorkspace& w, uint64_t* errors) const;
+    int decode(uint8_t* word);
+    uint64_t get_len() const;
+    uint64_t get_t() const;
+    uint64_t get_fft_points() const;
+    bool is_bit_order() const;
+};
+
+class ChaseDecoder {
+    /*
+     * Chase-II soft-decision decoder on top of BCHDecoder. The least reliable
+     * positions are flipped in all 2^flips combinations, visited in Gray code
+     * order so that syndromes are updated by a single flip per test pattern.
+     * Large searches split the test patterns between threads, all scratch is
+     * preallocated. The buffers follow t of the decoder: after set_distance
+     * on it they are reallocated by the next decode.
+     */
+private:
+    const BCHDecoder& dec;
+    uint64_t flips; // Number of least reliable positions to flip
+    unsigned threads; // Number of threads sharing the test patterns
+    uint64_t t; // Number of correctable errors the buffers are sized for
+    uint64_t syn_len; // Number of syndromes, 2t
+    uint64_t* order; // Positions sorted by reliability
+    int64_t* rank; // rank[p] = index of p among the flipped positions, -1 if not flipped
+    uint64_t* contrib; // contrib[f*syn_len+j] = change of syndrome j by flip f
+    uint64_t* syn; // Syndromes of the hard decision
+    uint64_t* lane_syn; // Per-thread running syndromes
+    uint64_t* lane_errors; // Per-thread errors of the current test pattern
+    uint64_t* lane_best; // Per-thread best errors found
+    int* lane_best_num; // Per-thread number of best errors, -1 if none
+    uint64_t* lane_best_pattern; // Per-thread best test pattern
+    float* lane_best_metric; // Per-thread best metric
+    BCHWorkspace** lanes; // Per-thread decoder scratch
+    uint8_t* hard; // Hard decisions
+    uint8_t hard_parity; // Parity of the hard decisions
+    void resize();
+    void run(unsigned lane, uint64_t begin, uint64_t end, const float* llr);
+public:
+    ChaseDecoder(const BCHDecoder& dec, uint64_t flips, unsigned threads = 1);
+    ChaseDecoder(const ChaseDecoder& x) = delete;
+    ChaseDecoder& operator=(const ChaseDecoder& x) = delete;
+    ~ChaseDecoder();
+    int decode(const float* llr, uint8_t* word);
+};
+
+#endif //BCHCODES_INCLUDE_BCHDECODER_H_
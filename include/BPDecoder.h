@@ -0,0 +1,78 @@
+#ifndef BCHCODES_INCLUDE_BPDECODER_H_
+#define BCHCODES_INCLUDE_BPDECODER_H_
+
+#include <cstdint>
+#include "BitMatrix.h"
+#include "GaussianElimination.h"
+
+class BPDecoder {
+    /*
+     * Min-sum belief propagation on a packed r x n check matrix. Messages are
+     * saturated int16 in units of 1/8 of an LLR, check node outputs are scaled
+     * by a normalization factor and/or reduced by an offset. A batch of frames
+     * is decoded at once with the frames interleaved, value (v, f) is at
+     * v*batch + f, so the node updates run on SSE2/AVX2 vectors of frames and
+     * every edge touches one contiguous run of memory. A frame stops as soon as
+     * its hard decision satisfies all checks. All buffers are allocated in the
+     * constructor.
+     */
+private:
+    uint64_t n; // Length of the code
+    uint64_t words; // Words per codeword
+    uint64_t checks; // Number of rows of the check matrix
+    uint64_t batch; // Frames per batch, a multiple of the vector width
+    int iterations; // Maximal number of iterations
+    int16_t norm; // Normalization factor in sixteenths
+    int16_t offset; // Offset in message units
+    uint64_t* row_start; // Edges of check c are row_start[c]..row_start[c+1]-1
+    uint64_t* edge_var; // Variable of every edge
+    uint64_t edge_capacity;
+    int16_t* c2v; // Check to variable messages, edge*batch + frame
+    int16_t* channel; // Quantized channel LLRs, v*batch + frame
+    int16_t* total; // Posterior LLRs of the last iteration, v*batch + frame
+    int16_t* next; // Posterior LLRs being accumulated
+    int16_t* unsat; // Negative if the frame violates a check
+    uint8_t* done; // The frame has its result
+    void load_batch(const float* llr, uint64_t frames);
+    void iterate();
+    void check();
+    void store_frame(uint64_t f, uint64_t* codeword, float* posterior) const;
+public:
+    BPDecoder(const BitMatrix& h, uint64_t batch = 32, int iterations = 20, float normalization = 0.75f, float offset = 0);
+    BPDecoder(const BPDecoder& x) = delete;
+    BPDecoder& operator=(const BPDecoder& x) = delete;
+    ~BPDecoder();
+    void set_check_matrix(const BitMatrix& h);
+    uint64_t decode(const float* llr, uint64_t frames, uint64_t* codewords, uint8_t* valid = nullptr, float* posterior = nullptr);
+    uint64_t get_batch() const;
+};
+
+class ABPDecoder {
+    /*
+     * Adaptive belief propagation: before every round the check matrix is
+     * re-eliminated so that its pivots sit on the least reliable positions,
+     * which makes it sparse where the errors most likely are, then a few
+     * min-sum iterations run on it and the LLRs move by a damped step towards
+     * their posteriors. Slower than plain min-sum since every round costs an
+     * elimination, one frame is decoded at a time.
+     */
+private:
+    BitMatrix h; // Check matrix of the code
+    BitMatrix adapted; // Check matrix eliminated on the least reliable positions
+    BPDecoder bp; // Min-sum iterations on the adapted matrix
+    uint64_t n; // Length of the code
+    int rounds; // Maximal number of adaptations
+    float damping; // Step towards the posteriors
+    uint64_t* order; // Positions by increasing reliability
+    uint64_t* pivots;
+    float* llr; // LLRs of the current round
+    float* post; // Posteriors of the current round
+public:
+    ABPDecoder(const BitMatrix& h, int rounds = 20, int iterations = 1, float damping = 0.25f, float normalization = 0.75f);
+    ABPDecoder(const ABPDecoder& x) = delete;
+    ABPDecoder& operator=(const ABPDecoder& x) = delete;
+    ~ABPDecoder();
+    bool decode(const float* llr, uint64_t* codeword);
+};
+
+#endif //BCHCODES_INCLUDE_BPDECODER_H_
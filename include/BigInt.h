@@ -0,0 +1,34 @@
+#ifndef BCHCODES_INCLUDE_BIGINT_H_
+#define BCHCODES_INCLUDE_BIGINT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class BigInt {
+    /*
+     * Signed integer of arbitrary size for exact weight enumerators.
+     * The magnitude is kept as 32-bit limbs, least significant first.
+     */
+private:
+    bool negative; // Sign, zero is never negative
+    std::vector<uint32_t> mag; // Magnitude, no leading zero limbs
+    void trim();
+    int cmp_mag(const BigInt& a) const;
+    void add_mag(const BigInt& a);
+    void sub_mag(const BigInt& a);
+public:
+    BigInt(int64_t x = 0);
+    static BigInt from_unsigned(uint64_t x);
+    BigInt& operator+=(const BigInt& a);
+    BigInt& operator-=(const BigInt& a);
+    BigInt& operator*=(int64_t x);
+    BigInt& operator>>=(uint64_t bits);
+    uint32_t div_small(uint32_t d);
+    bool operator==(const BigInt& a) const;
+    bool is_zero() const;
+    bool is_negative() const;
+    std::string to_string() const;
+};
+
+#endif //BCHCODES_INCLUDE_BIGINT_H_
@@ -0,0 +1,44 @@
+#ifndef BCHCODES_INCLUDE_BITMATRIX_H_
+#define BCHCODES_INCLUDE_BITMATRIX_H_
+
+#include <cstdint>
+
+class BitMatrix {
+    /*
+     * Dense matrix over GF(2). Every row is packed into 64-bit words,
+     * element (i, j) is bit j%64 of word j/64 of row i. Unused bits of the
+     * last word of a row are kept zero.
+     */
+private:
+    uint64_t rows; // Number of rows
+    uint64_t cols; // Number of columns
+    uint64_t words; // Number of words per row
+    uint64_t capacity; // Number of allocated words
+    uint64_t* data; // Rows one after another
+public:
+    BitMatrix();
+    BitMatrix(uint64_t rows, uint64_t cols);
+    BitMatrix(const BitMatrix& x);
+    ~BitMatrix();
+    BitMatrix& operator=(const BitMatrix& x);
+    void resize(uint64_t rows, uint64_t cols);
+    void clear();
+    uint64_t* row(uint64_t i);
+    const uint64_t* row(uint64_t i) const;
+    int get(uint64_t i, uint64_t j) const;
+    void set(uint64_t i, uint64_t j, int bit);
+    void flip(uint64_t i, uint64_t j);
+    void swap_rows(uint64_t i, uint64_t j);
+    void swap_cols(uint64_t i, uint64_t j);
+    uint64_t get_rows() const;
+    uint64_t get_cols() const;
+    uint64_t get_words() const;
+};
+
+void transpose64(uint64_t* a);
+void transpose(const BitMatrix& a, BitMatrix& t, unsigned threads = 1);
+bool multiply(const BitMatrix& a, const BitMatrix& b, BitMatrix& c, unsigned threads = 1);
+// The random matrix of is_orthogonal comes from seed, the default keeps the check reproducible
+bool is_orthogonal(const BitMatrix& g, const BitMatrix& h, unsigned threads = 1, uint64_t seed = 0x9E3779B97F4A7C15ULL);
+
+#endif //BCHCODES_INCLUDE_BITMATRIX_H_
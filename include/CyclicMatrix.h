@@ -0,0 +1,51 @@
+#ifndef BCHCODES_INCLUDE_CYCLICMATRIX_H_
+#define BCHCODES_INCLUDE_CYCLICMATRIX_H_
+
+#include <cstdint>
+#include <vector>
+
+struct CyclicWorkspace {
+    /*
+     * Product buffer of CyclicMatrix::mul and mul_transposed, grown on demand
+     * and reused so that repeated products allocate nothing. One per thread.
+     */
+    uint64_t* prod;
+    uint64_t size;
+    CyclicWorkspace();
+    CyclicWorkspace(const CyclicWorkspace& x) = delete;
+    CyclicWorkspace& operator=(const CyclicWorkspace& x) = delete;
+    ~CyclicWorkspace();
+    void reserve(uint64_t words);
+};
+
+class CyclicMatrix {
+    /*
+     * Implicit rows x cols matrix whose row i is x^i p(x), element (i, j) is
+     * the coefficient of x^(j-i) in p. With p = g and k rows it is the
+     * generator matrix of a cyclic code, with p the reversed check polynomial
+     * and n - k rows its check matrix. Only p is stored; rows and columns are
+     * produced on demand as packed words, the same layout as BitMatrix, and
+     * products with vectors are polynomial products, so memory stays O(n).
+     */
+private:
+    std::vector<uint64_t> poly; // p, packed
+    std::vector<uint64_t> rev; // p reversed, for columns and products with the transpose
+    uint64_t rows; // Number of rows
+    uint64_t cols; // Number of columns
+    uint64_t deg; // Degree of p, at most cols - rows
+public:
+    CyclicMatrix();
+    CyclicMatrix(const std::vector<uint64_t>& poly, uint64_t rows, uint64_t cols);
+    int get(uint64_t i, uint64_t j) const;
+    void row(uint64_t i, uint64_t* out) const;
+    void row_block(uint64_t first, uint64_t count, uint64_t* out) const;
+    void col(uint64_t j, uint64_t* out) const;
+    void mul(const uint64_t* x, uint64_t* y, CyclicWorkspace& w) const;
+    void mul_transposed(const uint64_t* y, uint64_t* s, CyclicWorkspace& w) const;
+    const std::vector<uint64_t>& get_poly() const;
+    uint64_t get_rows() const;
+    uint64_t get_cols() const;
+    uint64_t get_words() const;
+};
+
+#endif //BCHCODES_INCLUDE_CYCLICMATRIX_H_
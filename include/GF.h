@@ -8,7 +8,9 @@
 
 typedef unsigned __int128 uint128;
 
-const uint64_t PRIMITIVE_POLYS[17] =
+// Primitive polynomials; from m = 17 on they are trinomials or pentanomials,
+// so reduction modulo them is a few shifts and XORs
+const uint64_t PRIMITIVE_POLYS[33] =
         {
                 0,
                 0,
@@ -26,9 +28,27 @@ const uint64_t PRIMITIVE_POLYS[17] =
                 0b10000000011011,
                 0b100010001000011,
                 0b1000000000000011,
-                0b10001000000001011
+                0b10001000000001011,
+                (uint64_t(1) << 17) | (1 << 3) | 1,
+                (uint64_t(1) << 18) | (1 << 7) | 1,
+                (uint64_t(1) << 19) | (1 << 5) | (1 << 2) | (1 << 1) | 1,
+                (uint64_t(1) << 20) | (1 << 3) | 1,
+                (uint64_t(1) << 21) | (1 << 2) | 1,
+                (uint64_t(1) << 22) | (1 << 1) | 1,
+                (uint64_t(1) << 23) | (1 << 5) | 1,
+                (uint64_t(1) << 24) | (1 << 7) | (1 << 2) | (1 << 1) | 1,
+                (uint64_t(1) << 25) | (1 << 3) | 1,
+                (uint64_t(1) << 26) | (1 << 6) | (1 << 2) | (1 << 1) | 1,
+                (uint64_t(1) << 27) | (1 << 5) | (1 << 2) | (1 << 1) | 1,
+                (uint64_t(1) << 28) | (1 << 3) | 1,
+                (uint64_t(1) << 29) | (1 << 2) | 1,
+                (uint64_t(1) << 30) | (1 << 6) | (1 << 4) | (1 << 1) | 1,
+                (uint64_t(1) << 31) | (1 << 3) | 1,
+                (uint64_t(1) << 32) | (1 << 22) | (1 << 2) | (1 << 1) | 1
         };
 
+// Largest m for which GF(2^m) keeps log tables, larger fields compute on the fly
+const uint64_t GF2_TABLE_MAX_DEG = 16;
 
 class GF2 {
 /*
@@ -38,7 +58,14 @@ private:
     uint64_t deg; // Power of a primitive polynomial
     uint64_t primitive; // Primitive polynomial
     uint64_t num; // Number of non-zero elements
-    std::pair<uint64_t, uint64_t>* logs; // Table of logs as <element : generator power>
+    std::pair<uint64_t, uint64_t>* logs; // Table of logs as <element : generator power>, nullptr for large fields
+    uint64_t* index; // Inverse of logs: index[element] = generator power
+    std::vector<uint64_t> order_factors; // Prime factors of num, for logs in large fields
+    uint64_t reduce(uint64_t a) const;
+    uint64_t mul_large(uint64_t a, uint64_t b) const;
+    uint64_t pow_large(uint64_t a, uint64_t e) const;
+    uint64_t inv_large(uint64_t a) const;
+    uint64_t log_large(uint64_t a) const;
 public:
     GF2(uint64_t pow);
     GF2();
@@ -78,7 +105,8 @@ public:
     uint64_t& operator[](uint64_t i);
     uint64_t eval(const uint64_t& x) const;
     GF2X& operator=(const GF2X& a);
-    uint64_t get_deg();
+    uint64_t get_deg() const;
+    uint64_t get_coeff(uint64_t i) const;
     std::string print();
     uint64_t* roots(uint64_t& num);
 
@@ -88,6 +116,10 @@ uint128 mul_poly(uint128 a, uint128 b);
 void div_poly(const uint128& a, const uint128& b, uint128 &q, uint128 &r);
 uint128 gcd_poly(uint128 a, uint128 b);
 uint128 lcm_poly(uint128 a, uint128 b);
+// Binary polynomials of any degree: coefficient of x^i is bit i%64 of word i/64
+std::vector<uint64_t> mul_poly(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b);
+uint64_t deg_poly(const std::vector<uint64_t>& a);
+void div_poly(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, std::vector<uint64_t>& q, std::vector<uint64_t>& r);
 uint64_t mod(uint64_t a, uint64_t b);
 
 #endif //BCH_GF_H
@@ -3,7 +3,27 @@
 
 #include <algorithm>
 #include <cstring>
+#include "BitMatrix.h"
+
+struct GaussianWorkspace {
+    /*
+     * Buffers of the packed elimination, reused between calls so that
+     * repeated eliminations of same-sized matrices allocate nothing.
+     */
+    BitMatrix a;
+    uint64_t* order;
+    uint64_t size;
+    GaussianWorkspace();
+    GaussianWorkspace(const GaussianWorkspace& x) = delete;
+    GaussianWorkspace& operator=(const GaussianWorkspace& x) = delete;
+    ~GaussianWorkspace();
+    void reserve(uint64_t n);
+};
+
 int upperEchelonForm(int k, int n, int **newa);
 int gaussianElimination(int k, int n, int **a, int ***x);
+int upperEchelonForm(BitMatrix& a);
+int gaussianElimination(const BitMatrix& a, uint64_t k, BitMatrix& x, GaussianWorkspace& w);
+uint64_t reducedEchelonForm(BitMatrix& a, const uint64_t* order, uint64_t* pivots);
 
 #endif //BCHCODES_INCLUDE_GAUSSIANELIMINATION_H_
@@ -0,0 +1,43 @@
+#ifndef BCHCODES_INCLUDE_OSDDECODER_H_
+#define BCHCODES_INCLUDE_OSDDECODER_H_
+
+#include <cstdint>
+#include "BitMatrix.h"
+#include "GaussianElimination.h"
+
+class OSDDecoder {
+    /*
+     * Ordered-statistics decoder of order 0..3 for a binary linear code given by
+     * a packed k x n generator matrix. Positions are sorted by reliability, the
+     * generator is re-eliminated on the most reliable basis and re-encodings of
+     * low-weight changes of the basis bits are tried, one row XOR per candidate.
+     * All buffers are allocated in the constructor.
+     */
+private:
+    BitMatrix g; // Generator matrix of the code
+    BitMatrix sys; // Generator eliminated on the most reliable basis
+    uint64_t n; // Length of the code
+    uint64_t k; // Dimension of the code
+    uint64_t words; // Words per codeword
+    int order; // Maximal number of basis bits flipped at once
+    uint64_t dmin; // Lower bound on the minimal distance, 0 disables the optimality test
+    uint64_t* perm; // Positions by decreasing reliability
+    uint64_t* pivots; // pivots[r] = position of the basis bit of row r of sys
+    float* rel; // Reliabilities of the positions
+    uint64_t* hard; // Hard decisions, packed
+    uint64_t* acc; // acc[l*words..] = candidate XOR hard decision with l basis bits flipped
+    uint64_t* best; // Best candidate XOR hard decision
+    float best_metric;
+    bool optimal; // Best candidate passed the optimality test
+    float metric(const uint64_t* diff, float bound) const;
+    void consider(const uint64_t* diff, float info_cost);
+    bool is_optimal() const;
+public:
+    OSDDecoder(const BitMatrix& g, int order, uint64_t dmin = 0);
+    OSDDecoder(const OSDDecoder& x) = delete;
+    OSDDecoder& operator=(const OSDDecoder& x) = delete;
+    ~OSDDecoder();
+    float decode(const float* llr, uint64_t* codeword);
+};
+
+#endif //BCHCODES_INCLUDE_OSDDECODER_H_
@@ -0,0 +1,11 @@
+#ifndef BCHCODES_INCLUDE_PARALLEL_H_
+#define BCHCODES_INCLUDE_PARALLEL_H_
+
+#include <cstdint>
+#include <functional>
+
+unsigned default_threads();
+void parallel_for(uint64_t count, unsigned threads,
+                  const std::function<void(unsigned, uint64_t, uint64_t)>& body);
+
+#endif //BCHCODES_INCLUDE_PARALLEL_H_
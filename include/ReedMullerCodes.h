@@ -2,7 +2,37 @@
 #define BCHCODES_INCLUDE_REEDMULLERCODES_H_
 
 #include <cstdint>
-#include <ostream>
 
-void build_bch_matrices_bit_order(uint64_t n, uint64_t d, std::ostream& output);
+uint64_t rm_dimension(int r, int m);
+
+class RMCoder {
+    /*
+     * Reed-Muller code RM(r, m) of length 2^m built with the recursive
+     * Plotkin construction RM(r, m) = {(u|u+v) : u in RM(r, m-1), v in RM(r-1, m-1)}.
+     * Messages and codewords are packed into 64-bit words, bit i of word i/64
+     * is the i-th symbol. Message bits of u go first, then bits of v.
+     */
+private:
+    int r; // Order of the code
+    int m; // Log of the code length
+    uint64_t n; // Length of the code
+    uint64_t k; // Dimension of the code
+    uint64_t* dims; // dims[r'*(m+1)+m'] = dimension of RM(r', m')
+    float** llrs; // Decoder scratch: llrs[l] holds 2^(l-1) LLRs for the children at level l
+    uint8_t* bits; // Decoder scratch: hard decisions for the whole codeword
+    uint64_t dim(int r, int m) const;
+    uint64_t encode_word(int r, int m, const uint64_t* msg, uint64_t& pos) const;
+    void encode_words(int r, int m, const uint64_t* msg, uint64_t& pos, uint64_t* out) const;
+    void decode_rec(int r, int m, const float* y, uint8_t* out, uint64_t* msg, uint64_t pos);
+public:
+    RMCoder(int r, int m);
+    RMCoder(const RMCoder& x) = delete;
+    RMCoder& operator=(const RMCoder& x) = delete;
+    ~RMCoder();
+    void encode(const uint64_t* msg, uint64_t* codeword) const;
+    void decode(const float* llr, uint64_t* msg, uint64_t* codeword);
+    uint64_t get_n() const;
+    uint64_t get_k() const;
+};
+
 #endif //BCHCODES_INCLUDE_REEDMULLERCODES_H_
@@ -0,0 +1,48 @@
+#ifndef BCHCODES_INCLUDE_REEDSOLOMONCODES_H_
+#define BCHCODES_INCLUDE_REEDSOLOMONCODES_H_
+
+#include <cstdint>
+#include "GF.h"
+
+class RSCoder {
+    /*
+     * Reed-Solomon code RS(n, k) over GF(2^m), n <= 2^m - 1 (shorter n gives a shortened code).
+     * A codeword is stored highest degree first: k data symbols followed by n-k parity symbols.
+     * Roots of the generator polynomial are alpha^1, ..., alpha^(n-k).
+     * Invalid parameters give a coder with is_valid() false that decodes nothing.
+     */
+private:
+    GF2 field; // Field of the symbols
+    uint64_t n; // Length of the code
+    uint64_t k; // Dimension of the code
+    uint64_t nroots; // Number of parity symbols
+    uint64_t num; // Number of non-zero field elements
+    bool valid; // Parameters are valid
+    uint16_t* exp_table; // exp_table[i] = alpha^i for i < 2*num
+    uint16_t* log_table; // log_table[x] = i such that alpha^i = x, x != 0
+    uint16_t* gen; // Generator polynomial, gen[i] is the coefficient of x^i
+    uint16_t* region; // region[x*nroots+j] = x * gen[nroots-1-j], nullptr if too large
+    // Decoder scratch, allocated once
+    uint16_t* syn;
+    uint16_t* lambda;
+    uint16_t* b;
+    uint16_t* t;
+    uint16_t* omega;
+    uint64_t* reg;
+    uint64_t* root_pos;
+    uint64_t* root_inv;
+    uint8_t* erased; // erased[p] = 1 while erasure p is being checked
+    uint16_t mul(uint16_t a, uint16_t b) const;
+public:
+    RSCoder(uint64_t n, uint64_t k, uint64_t m = 8);
+    RSCoder(const RSCoder& x) = delete;
+    RSCoder& operator=(const RSCoder& x) = delete;
+    ~RSCoder();
+    void encode(const uint16_t* data, uint16_t* parity) const;
+    int decode(uint16_t* codeword, const uint64_t* erasures = nullptr, uint64_t num_erasures = 0);
+    bool is_valid() const;
+    uint64_t get_n() const;
+    uint64_t get_k() const;
+};
+
+#endif //BCHCODES_INCLUDE_REEDSOLOMONCODES_H_
@@ -0,0 +1,40 @@
+#ifndef BCHCODES_INCLUDE_SYNDROMETABLE_H_
+#define BCHCODES_INCLUDE_SYNDROMETABLE_H_
+
+#include <cstdint>
+#include <vector>
+#include "BitMatrix.h"
+
+class SyndromeTable {
+    /*
+     * Syndrome decoder for short codes. For every syndrome the table keeps
+     * the positions of its coset leader of weight <= t (t slots of uint16_t,
+     * unused slots are EMPTY, syndromes without a leader start with UNKNOWN).
+     * The table can be saved and mapped back from a file with mmap; the header
+     * of a mapped file is validated, optionally against the expected code.
+     */
+private:
+    BitMatrix h; // Check matrix
+    uint64_t n; // Length of the code
+    uint64_t r; // Number of syndrome bits
+    uint64_t t; // Maximal weight of the coset leaders
+    uint16_t* table; // 2^r entries of t slots
+    void* mapping; // Mapped file, nullptr if the table is in memory
+    uint64_t mapping_size;
+    void fill(uint64_t weight, const std::vector<uint64_t>& cols, unsigned threads);
+public:
+    static const uint16_t EMPTY = 0xFFFF;
+    static const uint16_t UNKNOWN = 0xFFFE;
+    static const uint64_t MAX_SYNDROME_BITS = 24;
+    SyndromeTable(const BitMatrix& h, uint64_t t, unsigned threads = 0);
+    SyndromeTable(const char* path, const BitMatrix* code = nullptr);
+    SyndromeTable(const SyndromeTable& x) = delete;
+    SyndromeTable& operator=(const SyndromeTable& x) = delete;
+    ~SyndromeTable();
+    bool save(const char* path) const;
+    bool is_valid() const;
+    uint64_t syndrome(const uint64_t* word) const;
+    int decode(uint64_t* word) const;
+};
+
+#endif //BCHCODES_INCLUDE_SYNDROMETABLE_H_
@@ -0,0 +1,14 @@
+#ifndef BCHCODES_INCLUDE_WEIGHTDISTRIBUTION_H_
+#define BCHCODES_INCLUDE_WEIGHTDISTRIBUTION_H_
+
+#include <cstdint>
+#include <vector>
+#include "BitMatrix.h"
+#include "BigInt.h"
+
+std::vector<uint64_t> weight_distribution(const BitMatrix& g, unsigned threads = 0, uint64_t stop_below = 0);
+uint64_t minimum_distance(const BitMatrix& g, unsigned threads = 0, uint64_t target = 0);
+std::vector<BigInt> macwilliams(const std::vector<uint64_t>& dual, uint64_t dual_dim);
+std::vector<BigInt> weight_spectrum(const BitMatrix& g, const BitMatrix& h, unsigned threads = 0);
+
+#endif //BCHCODES_INCLUDE_WEIGHTDISTRIBUTION_H_
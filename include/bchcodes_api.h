@@ -0,0 +1,73 @@
+#ifndef BCHCODES_INCLUDE_BCHCODES_API_H_
+#define BCHCODES_INCLUDE_BCHCODES_API_H_
+
+/*
+ * C interface of the bchcodes library. A code is an opaque handle built once;
+ * matrices, the generator polynomial and codewords are exchanged as packed bits:
+ * bit j of a row is bit j%64 of word j/64, every row takes bch_code_words()
+ * words and unused bits of the last word are zero. Nothing is allocated after
+ * bch_code_create, all output goes to buffers of the caller. A handle may be
+ * read from many threads, bch_code_decode needs one handle per thread.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Extended code of length n+1, column i is the field element i and column 0 the overall parity */
+#define BCH_LAYOUT_BIT_ORDER 0
+/* Cyclic code of length n in systematic form, G = [P | I], H = [I | P^T] */
+#define BCH_LAYOUT_SYSTEMATIC 1
+/* Systematic code extended by the overall parity as column n */
+#define BCH_LAYOUT_SYSTEMATIC_EXTENDED 2
+
+/* OR'd into the layout: skip the check made when the matrices are built, G H^T = 0 for
+ * every layout, preceded by g(x) dividing x^n + 1 for the systematic ones */
+#define BCH_NO_VERIFY 0x100
+/* OR'd into the layout: threads building and checking the matrices, 0 (default) for all cores */
+#define BCH_THREADS(t) ((int)((t) & 0x7FFF) << 16)
+
+typedef struct bch_code bch_code;
+
+/*
+ * Narrow-sense binary BCH code, n = 2^m - 1 with 2 <= m <= 20, designed distance 1 < d <= n.
+ * NULL on error, including matrices failing the check.
+ */
+bch_code* bch_code_create(uint64_t n, uint64_t d, int layout);
+void bch_code_destroy(bch_code* code);
+
+uint64_t bch_code_length(const bch_code* code);
+uint64_t bch_code_dimension(const bch_code* code);
+uint64_t bch_code_check_rows(const bch_code* code);
+uint64_t bch_code_words(const bch_code* code);
+uint64_t bch_code_poly_words(const bch_code* code);
+
+/* G as dimension x words words, H as check_rows x words words. */
+void bch_code_get_generator(const bch_code* code, uint64_t* g);
+void bch_code_get_check(const bch_code* code, uint64_t* h);
+/* Generator polynomial of the cyclic code, coefficient of x^i is bit i; returns its degree. */
+uint64_t bch_code_get_generator_poly(const bch_code* code, uint64_t* poly);
+
+/*
+ * Every distinct narrow-sense BCH code of length n, from the largest designed
+ * distance 3 up to the repetition code, built incrementally in one pass. fn gets
+ * each code with the largest designed distance giving it; the handle lives only
+ * during the call. layout is BCH_LAYOUT_SYSTEMATIC or BCH_LAYOUT_SYSTEMATIC_EXTENDED.
+ * Returns the number of codes or -1 on error, including a code failing the check,
+ * which stops the sweep before fn sees that code.
+ */
+typedef void (*bch_sweep_callback)(bch_code* code, uint64_t d, void* context);
+int64_t bch_code_sweep(uint64_t n, int layout, bch_sweep_callback fn, void* context);
+
+/* codeword = message * G, the message takes (dimension+63)/64 words. */
+void bch_code_encode(const bch_code* code, const uint64_t* message, uint64_t* codeword);
+/* Hard-decision decoding in place, returns the number of corrected bits or -1. */
+int bch_code_decode(bch_code* code, uint64_t* word);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BCHCODES_INCLUDE_BCHCODES_API_H_
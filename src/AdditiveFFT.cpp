@@ -0,0 +1,249 @@
+#include <iostream>
+#include <cstring>
+#include <vector>
+#include "AdditiveFFT.h"
+
+AdditiveFFT::AdditiveFFT(const GF2& field)
+{
+    deg = field.get_deg();
+    num = field.get_num();
+    points = uint64_t(1) << deg;
+    exps = new uint64_t[2*num];
+    lg = new uint64_t[num+1];
+    lg[0] = num;
+    uint64_t x = 1;
+    for(uint64_t i=0; i<num; ++i)
+    {
+        exps[i] = exps[i+num] = x;
+        lg[x] = i;
+        x = field.mul(x, 2);
+    }
+    // Level l works on the 2^(m-l) points spanned by its basis, every level
+    // needs 2^(m-l) scaling factors and 2^(m-l-1) subspace points
+    scale_offset = new uint64_t[deg+1];
+    twist_offset = new uint64_t[deg+1];
+    scale_offset[0] = twist_offset[0] = 0;
+    for(uint64_t l=0; l<deg; ++l)
+    {
+        scale_offset[l+1] = scale_offset[l] + (uint64_t(1) << (deg-l));
+        twist_offset[l+1] = twist_offset[l] + (uint64_t(1) << (deg-l-1));
+    }
+    scale = new uint64_t[scale_offset[deg] + 1];
+    twist = new uint64_t[twist_offset[deg] + 1];
+    std::vector<uint64_t> basis(deg);
+    for(uint64_t i=0; i<deg; ++i)
+    {
+        basis[i] = uint64_t(1) << i;
+    }
+    std::vector<uint64_t> span(points/2);
+    for(uint64_t l=0; l<deg; ++l)
+    {
+        uint64_t dim = deg - l;
+        uint64_t beta = lg[basis[dim-1]];
+        uint64_t* sc = scale + scale_offset[l];
+        uint64_t s = 0;
+        for(uint64_t i=0; i<(uint64_t(1) << dim); ++i)
+        {
+            sc[i] = s;
+            s += beta;
+            s = s >= num ? s - num : s;
+        }
+        // gamma_i = basis_i / beta, the points of the level are span(gamma) and span(gamma) + 1
+        span[0] = 0;
+        for(uint64_t i=0; i+1<dim; ++i)
+        {
+            uint64_t gamma = mul_lg(basis[i], num - beta);
+            for(uint64_t j=0; j<(uint64_t(1) << i); ++j)
+            {
+                span[(uint64_t(1) << i) + j] = span[j] ^ gamma;
+            }
+            // Next basis delta_i = gamma_i^2 + gamma_i
+            basis[i] = mul_lg(gamma, lg[gamma]) ^ gamma;
+        }
+        uint64_t* tw = twist + twist_offset[l];
+        for(uint64_t j=0; j<(uint64_t(1) << (dim-1)); ++j)
+        {
+            tw[j] = lg[span[j]];
+        }
+    }
+}
+
+AdditiveFFT::~AdditiveFFT()
+{
+    delete[] exps;
+    delete[] lg;
+    delete[] scale;
+    delete[] twist;
+    delete[] scale_offset;
+    delete[] twist_offset;
+}
+
+inline uint64_t AdditiveFFT::mul_lg(uint64_t a, uint64_t b_lg) const
+{
+    if(a == 0 || b_lg == num)
+    {
+        return 0;
+    }
+    return exps[lg[a] + b_lg];
+}
+
+static void taylor_expand(uint64_t* f, uint64_t len)
+{
+    /*
+     * Taylor expansion at x^2 + x: afterwards f(x) = sum (f[2i] + f[2i+1] x)(x^2 + x)^i.
+     * With q = len/4 and x^2q = (x^2 + x)^q + x^q the top half folds into the
+     * quarters below it, then both halves are expanded on their own.
+     */
+    if(len <= 2)
+    {
+        return;
+    }
+    uint64_t q = len / 4;
+    for(uint64_t i=0; i<q; ++i)
+    {
+        f[2*q+i] ^= f[3*q+i];
+    }
+    for(uint64_t i=0; i<q; ++i)
+    {
+        f[q+i] ^= f[2*q+i];
+    }
+    taylor_expand(f, len/2);
+    taylor_expand(f + len/2, len/2);
+}
+
+static void taylor_collapse(uint64_t* f, uint64_t len)
+{
+    /* Inverse of taylor_expand. */
+    if(len <= 2)
+    {
+        return;
+    }
+    uint64_t q = len / 4;
+    taylor_collapse(f, len/2);
+    taylor_collapse(f + len/2, len/2);
+    for(uint64_t i=0; i<q; ++i)
+    {
+        f[q+i] ^= f[2*q+i];
+    }
+    for(uint64_t i=0; i<q; ++i)
+    {
+        f[2*q+i] ^= f[3*q+i];
+    }
+}
+
+void AdditiveFFT::evaluate_level(uint64_t* f, uint64_t len, uint64_t level, uint64_t* values, uint64_t* scratch) const
+{
+    /*
+     * f(beta x) = g0(x^2 + x) + x g1(x^2 + x), g0 and g1 are evaluated on the
+     * next level and combined: g(a) = g0(a^2 + a) + a g1(a^2 + a), g(a + 1) = g(a) + g1(a^2 + a).
+     */
+    uint64_t count = uint64_t(1) << (deg - level);
+    if(len == 1)
+    {
+        for(uint64_t i=0; i<count; ++i)
+        {
+            values[i] = f[0];
+        }
+        return;
+    }
+    const uint64_t* sc = scale + scale_offset[level];
+    for(uint64_t i=1; i<len; ++i)
+    {
+        f[i] = mul_lg(f[i], sc[i]);
+    }
+    taylor_expand(f, len);
+    uint64_t half = len / 2;
+    for(uint64_t i=0; i<half; ++i)
+    {
+        scratch[i] = f[2*i];
+        scratch[half+i] = f[2*i+1];
+    }
+    memcpy(f, scratch, sizeof(uint64_t)*len);
+    uint64_t mid = count / 2;
+    evaluate_level(f, half, level+1, values, scratch);
+    evaluate_level(f + half, half, level+1, values + mid, scratch);
+    const uint64_t* tw = twist + twist_offset[level];
+    for(uint64_t j=0; j<mid; ++j)
+    {
+        values[j] ^= mul_lg(values[mid+j], tw[j]);
+        values[mid+j] ^= values[j];
+    }
+}
+
+void AdditiveFFT::interpolate_level(uint64_t* values, uint64_t level, uint64_t* scratch) const
+{
+    /* Inverse of evaluate_level on a full-length polynomial. */
+    uint64_t count = uint64_t(1) << (deg - level);
+    if(count == 1)
+    {
+        return;
+    }
+    uint64_t mid = count / 2;
+    const uint64_t* tw = twist + twist_offset[level];
+    for(uint64_t j=0; j<mid; ++j)
+    {
+        values[mid+j] ^= values[j];
+        values[j] ^= mul_lg(values[mid+j], tw[j]);
+    }
+    interpolate_level(values, level+1, scratch);
+    interpolate_level(values + mid, level+1, scratch);
+    for(uint64_t i=0; i<mid; ++i)
+    {
+        scratch[2*i] = values[i];
+        scratch[2*i+1] = values[mid+i];
+    }
+    memcpy(values, scratch, sizeof(uint64_t)*count);
+    taylor_collapse(values, count);
+    const uint64_t* sc = scale + scale_offset[level];
+    for(uint64_t i=1; i<count; ++i)
+    {
+        values[i] = mul_lg(values[i], sc[i] == 0 ? 0 : num - sc[i]);
+    }
+}
+
+void AdditiveFFT::evaluate(uint64_t* coeffs, uint64_t len, uint64_t* values, uint64_t* scratch) const
+{
+    /*
+     * values[x] = f(x) for all 2^m elements x. coeffs[i] is the coefficient of x^i,
+     * len is a power of two not above 2^m, coeffs is destroyed. scratch holds len elements.
+     */
+    if(len > points || __builtin_popcountll(len) != 1)
+    {
+        std::cerr<<"Invalid length for additive FFT: "<<len<<std::endl;
+        return;
+    }
+    evaluate_level(coeffs, len, 0, values, scratch);
+}
+
+void AdditiveFFT::evaluate(const GF2X& f, uint64_t* values) const
+{
+    uint64_t len = 1;
+    while(len <= f.get_deg())
+    {
+        len <<= 1;
+    }
+    uint64_t* coeffs = new uint64_t[len];
+    uint64_t* scratch = new uint64_t[len];
+    memset(coeffs, 0, sizeof(uint64_t)*len);
+    for(uint64_t i=0; i<=f.get_deg(); ++i)
+    {
+        coeffs[i] = f.get_coeff(i);
+    }
+    evaluate(coeffs, len, values, scratch);
+    delete[] coeffs;
+    delete[] scratch;
+}
+
+void AdditiveFFT::interpolate(uint64_t* values, uint64_t* scratch) const
+{
+    /*
+     * Inverse transform: replaces the values at all 2^m elements by the
+     * coefficients of the unique polynomial of degree below 2^m taking them.
+     * scratch holds 2^m elements.
+     */
+    interpolate_level(values, 0, scratch);
+}
+
+uint64_t AdditiveFFT::get_points() const {
+    return points;
+}
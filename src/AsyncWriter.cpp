@@ -0,0 +1,389 @@
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "AsyncWriter.h"
+
+// Size of the buffer of formatted text and the alignment O_DIRECT needs
+static const uint64_t STAGE_SIZE = uint64_t(1) << 20;
+static const uint64_t DIRECT_ALIGN = 4096;
+
+AsyncWriter::AsyncWriter(std::ostream& output, bool threaded, uint64_t slot_count, uint64_t slot_words)
+{
+    this->threaded = threaded;
+    this->output = &output;
+    fd = -1;
+    own_fd = false;
+    direct = false;
+    failed = false;
+    init(slot_count, slot_words);
+}
+
+AsyncWriter::AsyncWriter(int fd, bool threaded, uint64_t slot_count, uint64_t slot_words)
+{
+    this->threaded = threaded;
+    output = nullptr;
+    this->fd = fd;
+    own_fd = false;
+    direct = false;
+    failed = fd < 0;
+    init(slot_count, slot_words);
+}
+
+AsyncWriter::AsyncWriter(const char* path, bool direct, bool threaded, uint64_t slot_count, uint64_t slot_words)
+{
+    this->threaded = threaded;
+    output = nullptr;
+    own_fd = true;
+    this->direct = false;
+    fd = -1;
+#ifdef O_DIRECT
+    if(direct)
+    {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        if(fd < 0)
+        {
+            std::cerr<<"Can't open "<<path<<" with O_DIRECT, writing through the page cache"<<std::endl;
+        }
+        this->direct = fd >= 0;
+    }
+#else
+    if(direct)
+    {
+        std::cerr<<"O_DIRECT is not supported, writing through the page cache"<<std::endl;
+    }
+#endif
+    if(fd < 0)
+    {
+        fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    failed = fd < 0;
+    if(failed)
+    {
+        std::cerr<<"Can't open "<<path<<" for writing"<<std::endl;
+    }
+    init(slot_count, slot_words);
+}
+
+void AsyncWriter::init(uint64_t slot_count, uint64_t slot_words)
+{
+    /* Without the thread the ring is never used and its slots get no storage. */
+    finished = false;
+    this->slot_count = slot_count == 0 ? 1 : slot_count;
+    this->slot_words = slot_words == 0 ? 1 : slot_words;
+    slots = new Slot[this->slot_count];
+    for(uint64_t i=0; i<this->slot_count; ++i)
+    {
+        slots[i].words = threaded ? new uint64_t[this->slot_words] : nullptr;
+        slots[i].capacity = threaded ? this->slot_words : 0;
+        slots[i].rows = 0;
+        slots[i].cols = 0;
+    }
+    head.store(0);
+    tail.store(0);
+    done.store(false);
+    producer_waiting.store(false);
+    writer_waiting.store(false);
+    stage_size = STAGE_SIZE;
+    stage_used = 0;
+    void* buf = nullptr;
+    if(posix_memalign(&buf, DIRECT_ALIGN, stage_size) != 0)
+    {
+        buf = nullptr;
+        failed = true;
+    }
+    stage = static_cast<char*>(buf);
+    if(threaded)
+    {
+        writer = std::thread(&AsyncWriter::run, this);
+    }
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    finish();
+    for(uint64_t i=0; i<slot_count; ++i)
+    {
+        delete[] slots[i].words;
+    }
+    delete[] slots;
+    free(stage);
+}
+
+AsyncWriter::Slot& AsyncWriter::acquire()
+{
+    /*
+     * Waiting until the writer releases a slot, the ring is bounded. The flag is
+     * set before tail is read again under the lock, so the writer either sees it
+     * and wakes this thread or has stored the tail that the check reads.
+     */
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if(h - tail.load(std::memory_order_acquire) >= slot_count)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        producer_waiting.store(true);
+        space.wait(guard, [&] { return h - tail.load() < slot_count; });
+        producer_waiting.store(false);
+    }
+    Slot& s = slots[h % slot_count];
+    s.text.clear();
+    s.rows = 0;
+    return s;
+}
+
+void AsyncWriter::publish()
+{
+    /* Lock-free unless the writer sleeps on an empty ring. */
+    head.store(head.load(std::memory_order_relaxed) + 1);
+    if(writer_waiting.load())
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+        }
+        data.notify_one();
+    }
+}
+
+void AsyncWriter::text(const std::string& s)
+{
+    if(!threaded)
+    {
+        put(s.data(), s.size());
+        return;
+    }
+    Slot& slot = acquire();
+    slot.text = s;
+    publish();
+}
+
+void AsyncWriter::rows(const uint64_t* packed, uint64_t rows, uint64_t cols)
+{
+    /* Copying the rows into slots of about slot_words words, at least one row per slot. */
+    if(!threaded)
+    {
+        format(packed, rows, cols);
+        return;
+    }
+    uint64_t words = (cols + 63) >> 6;
+    uint64_t per_slot = words == 0 ? rows : slot_words / words;
+    per_slot = per_slot == 0 ? 1 : per_slot;
+    for(uint64_t first=0; first<rows; first+=per_slot)
+    {
+        uint64_t count = rows - first < per_slot ? rows - first : per_slot;
+        Slot& slot = acquire();
+        if(slot.capacity < count*words)
+        {
+            delete[] slot.words;
+            slot.capacity = count*words;
+            slot.words = new uint64_t[slot.capacity];
+        }
+        memcpy(slot.words, packed + first*words, sizeof(uint64_t)*count*words);
+        slot.rows = count;
+        slot.cols = cols;
+        publish();
+    }
+}
+
+void AsyncWriter::rows(const BitMatrix& a)
+{
+    if(a.get_rows() != 0)
+    {
+        rows(a.row(0), a.get_rows(), a.get_cols());
+    }
+}
+
+void AsyncWriter::run()
+{
+    /* Writer thread: formatting and writing slots until the producer is done. */
+    for(;;)
+    {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        if(t == head.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            writer_waiting.store(true);
+            data.wait(guard, [&] { return t != head.load() || done.load(); });
+            writer_waiting.store(false);
+            if(t == head.load())
+            {
+                break;
+            }
+        }
+        Slot& slot = slots[t % slot_count];
+        put(slot.text.data(), slot.text.size());
+        format(slot.words, slot.rows, slot.cols);
+        tail.store(t + 1);
+        if(producer_waiting.load())
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+            }
+            space.notify_one();
+        }
+    }
+    flush_stage(true);
+}
+
+void AsyncWriter::format(const uint64_t* packed, uint64_t rows, uint64_t cols)
+{
+    /* Rows as "b b ... b \n" into the stage. */
+    if(stage == nullptr)
+    {
+        return;
+    }
+    uint64_t words = (cols + 63) >> 6;
+    for(uint64_t i=0; i<rows; ++i)
+    {
+        const uint64_t* row = packed + i*words;
+        for(uint64_t w=0; w<words; ++w)
+        {
+            if(stage_size - stage_used < 129)
+            {
+                flush_stage(false);
+            }
+            uint64_t bits = row[w];
+            uint64_t count = cols - 64*w < 64 ? cols - 64*w : 64;
+            char* out = stage + stage_used;
+            for(uint64_t j=0; j<count; ++j)
+            {
+                out[2*j] = char('0' + ((bits >> j) & 1));
+                out[2*j+1] = ' ';
+            }
+            stage_used += 2*count;
+        }
+        if(stage_used == stage_size)
+        {
+            flush_stage(false);
+        }
+        stage[stage_used++] = '\n';
+    }
+}
+
+void AsyncWriter::put(const char* data, uint64_t size)
+{
+    if(stage == nullptr)
+    {
+        return;
+    }
+    while(size != 0)
+    {
+        uint64_t part = stage_size - stage_used < size ? stage_size - stage_used : size;
+        memcpy(stage + stage_used, data, part);
+        stage_used += part;
+        data += part;
+        size -= part;
+        if(stage_used == stage_size)
+        {
+            flush_stage(false);
+        }
+    }
+}
+
+static bool write_all(int fd, const char* data, uint64_t size)
+{
+    while(size != 0)
+    {
+        ssize_t res = write(fd, data, size);
+        if(res < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(res <= 0)
+        {
+            return false;
+        }
+        data += res;
+        size -= uint64_t(res);
+    }
+    return true;
+}
+
+void AsyncWriter::flush_stage(bool last)
+{
+    /*
+     * Writing the formatted text. With O_DIRECT only whole aligned blocks are
+     * written, the rest stays at the start of the buffer; the last call drops
+     * O_DIRECT for the tail.
+     */
+    if(stage == nullptr)
+    {
+        return;
+    }
+    if(failed)
+    {
+        stage_used = 0;
+        return;
+    }
+    if(output != nullptr)
+    {
+        output->write(stage, stage_used);
+        if(last)
+        {
+            output->flush();
+        }
+        failed = !output->good();
+        stage_used = 0;
+        return;
+    }
+    uint64_t size = stage_used;
+    if(direct)
+    {
+        size = stage_used & ~(DIRECT_ALIGN - 1);
+    }
+    if(!write_all(fd, stage, size))
+    {
+        std::cerr<<"Writing the output failed: "<<strerror(errno)<<std::endl;
+        failed = true;
+        stage_used = 0;
+        return;
+    }
+    memmove(stage, stage + size, stage_used - size);
+    stage_used -= size;
+    if(last && stage_used != 0)
+    {
+#ifdef O_DIRECT
+        int flags = fcntl(fd, F_GETFL);
+        fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+#endif
+        failed = !write_all(fd, stage, stage_used);
+        if(failed)
+        {
+            std::cerr<<"Writing the output failed: "<<strerror(errno)<<std::endl;
+        }
+        stage_used = 0;
+    }
+}
+
+bool AsyncWriter::finish()
+{
+    /* Waiting for the writer to drain the ring, returns false if any write failed. */
+    if(finished)
+    {
+        return !failed;
+    }
+    finished = true;
+    if(writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done.store(true, std::memory_order_release);
+        }
+        data.notify_one();
+        writer.join();
+    }
+    else
+    {
+        flush_stage(true);
+    }
+    if(own_fd && fd >= 0)
+    {
+        if(close(fd) != 0)
+        {
+            failed = true;
+        }
+        fd = -1;
+    }
+    return !failed;
+}
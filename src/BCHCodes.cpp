@@ -1,186 +1,461 @@
 #include <iostream>
 #include <cstring>
-#include <GaussianElimination.h>
+#include <vector>
+#include <functional>
+#include "GaussianElimination.h"
 #include "GF.h"
+#include "Parallel.h"
+#include "AsyncWriter.h"
 #include "../include/BCHCodes.h"
 
+static std::vector<uint64_t> reverse_poly(const std::vector<uint64_t>& a)
+{
+    /* x^deg a(1/x). */
+    uint64_t deg = deg_poly(a);
+    std::vector<uint64_t> ans(deg / 64 + 1, 0);
+    for(uint64_t t=0; t<=deg; ++t)
+    {
+        ans[t >> 6] |= ((a[(deg-t) >> 6] >> ((deg-t) & 63)) & 1) << (t & 63);
+    }
+    return ans;
+}
+
+static std::string poly_bits(const std::vector<uint64_t>& poly, uint64_t width)
+{
+    /* Coefficients from x^(width-1) down to 1. */
+    std::string ans(width, '0');
+    for(uint64_t i=0; i<width && i < 64*poly.size(); ++i)
+    {
+        if((poly[i >> 6] >> (i & 63)) & 1)
+        {
+            ans[width-1-i] = '1';
+        }
+    }
+    return ans;
+}
+
+static void write_rows(const CyclicMatrix& a, AsyncWriter& writer)
+{
+    /* Rows are produced a block at a time, the full matrix never exists. */
+    uint64_t words = a.get_words();
+    uint64_t per_block = words >= (uint64_t(1) << 16) ? 1 : (uint64_t(1) << 16) / words;
+    std::vector<uint64_t> block(per_block * words);
+    for(uint64_t first=0; first<a.get_rows(); first+=per_block)
+    {
+        uint64_t count = a.get_rows() - first < per_block ? a.get_rows() - first : per_block;
+        a.row_block(first, count, block.data());
+        writer.rows(block.data(), count, a.get_cols());
+    }
+}
+
 void build_bch_matrices(uint64_t n, uint64_t d, std::ostream& output)
 {
-    if(__builtin_popcount(n+1) > 1)
+    /*
+     * Non-systematic matrices of the cyclic code: rows of G are shifts of g(x),
+     * rows of H shifts of the reversed h(x) = (x^n + 1) / g(x). Polynomials
+     * are printed with at least 128 digits.
+     */
+    CyclicMatrix g, h;
+    bch_matrix_views(n, d, g, h);
+    uint64_t k = g.get_rows();
+    std::vector<uint64_t> check = reverse_poly(h.get_poly());
+    uint64_t width = n < 128 ? 128 : n + 1;
+    // Row blocks are formatted on the writer thread while the next ones are generated
+    AsyncWriter writer(output);
+    writer.text("Built a (" + std::to_string(n) + ", " + std::to_string(k) + ") coder with gen poly\n" +
+                poly_bits(g.get_poly(), width) + "\nand check poly\n" + poly_bits(check, width) + "\n");
+    writer.text("Gen matrix:\n");
+    write_rows(g, writer);
+    writer.text("Check matrix:\n");
+    write_rows(h, writer);
+    writer.finish();
+}
+
+static uint64_t length_degree(uint64_t n)
+{
+    /* m such that n = 2^m - 1. */
+    if(__builtin_popcountll(n+1) > 1)
     {
         std::cerr << "Length is not a 2^m-1"<<std::endl;
     }
     uint64_t pow = 0;
-    uint128 tmp = n;
-    tmp += 1;
-    while(tmp > 0)
+    uint64_t tmp = n + 1;
+    while(tmp > 1)
     {
         ++pow;
         tmp >>= 1;
     }
-    --pow;
-    GF2 field(pow);
-    uint128 b = 2;
-    uint128 bpow = b;
-    uint128 gen = field.min_poly(b);
-    for(uint64_t i=2; i<d; ++i)
+    return pow;
+}
+
+static uint64_t coset_leaders(uint64_t n, uint64_t d, std::vector<uint64_t>& leaders)
+{
+    /*
+     * Leaders of the cyclotomic cosets modulo n met by 1, ..., d-1, i.e. the
+     * distinct minimal polynomials of the generator. Returns the degree of the generator.
+     */
+    std::vector<bool> covered(n, false);
+    uint64_t deg = 0;
+    leaders.clear();
+    for(uint64_t i=1; i<d; ++i)
     {
-        bpow = field.mul(bpow, b);
-        gen = lcm_poly(gen, field.min_poly(bpow));
+        if(covered[i % n])
+        {
+            continue;
+        }
+        leaders.push_back(i);
+        uint64_t c = i % n;
+        do
+        {
+            covered[c] = true;
+            ++deg;
+            c = (2*c) % n;
+        } while(c != i % n);
     }
-    tmp = gen;
-    uint64_t k = 0;
-    while(tmp > 0)
+    return deg;
+}
+
+std::vector<uint64_t> bch_generator_poly(uint64_t n, uint64_t d)
+{
+    /* Generator of the narrow-sense BCH code: product of the minimal polynomials of alpha^leader. */
+    GF2 field(length_degree(n));
+    std::vector<uint64_t> leaders;
+    coset_leaders(n, d, leaders);
+    std::vector<uint64_t> gen(1, 1);
+    for(uint64_t i=0; i<leaders.size(); ++i)
     {
-        ++k;
-        tmp >>= 1;
+        uint128 mp = field.min_poly(field.pow(2, int(leaders[i])));
+        std::vector<uint64_t> factor(2);
+        factor[0] = uint64_t(mp);
+        factor[1] = uint64_t(mp >> 64);
+        gen = mul_poly(gen, factor);
     }
-    --k;
-    k = n - k;
-    uint128 hgen, res;
-    div_poly((uint128(1)<<n)+1, gen, hgen, res);
-    output<<"Built a ("<<n<<", "<<k<<") coder with gen poly\n"
-             <<std::bitset<128>(gen) <<"\nand check poly\n"
-             <<std::bitset<128>(hgen)<<std::endl;
-    uint128* g = new uint128[k];
-    uint128* h = new uint128[n-k];
-    uint64_t hdeg = 0;
-    tmp = hgen;
-    while(tmp > 0)
-    {
-        ++hdeg;
-        tmp >>= 1;
-    }
-    --hdeg;
+    return gen;
+}
 
-    for(uint64_t i=0; i<k; ++i)
+void cyclic_matrix_views(uint64_t n, const std::vector<uint64_t>& gen, CyclicMatrix& g, CyclicMatrix& h)
+{
+    /* G has the k = n - deg g shifts of g(x), H the n - k shifts of the reversed h(x) = (x^n + 1) / g(x). */
+    uint64_t r = deg_poly(gen);
+    std::vector<uint64_t> xn((n >> 6) + 1, 0);
+    xn[0] = 1;
+    xn[n >> 6] |= uint64_t(1) << (n & 63);
+    std::vector<uint64_t> hgen, rem;
+    div_poly(xn, gen, hgen, rem);
+    g = CyclicMatrix(gen, n - r, n);
+    h = CyclicMatrix(reverse_poly(hgen), r, n);
+}
+
+void bch_matrix_views(uint64_t n, uint64_t d, CyclicMatrix& g, CyclicMatrix& h)
+{
+    cyclic_matrix_views(n, bch_generator_poly(n, d), g, h);
+}
+
+static bool verify_matrices(const BitMatrix& g, const BitMatrix& h, unsigned threads)
+{
+    /* G H^T = 0, a failure is a bug of the builder and is reported here. */
+    if(is_orthogonal(g, h, threads))
     {
-        g[i] = gen << i;
+        return true;
     }
-    for(uint64_t i=0; i<n-k; ++i)
-    {
-        h[i] = 0;
-        for(uint64_t j=0; j<=hdeg; ++j)
+    std::cerr<<"Generator and check matrices of length "<<g.get_cols()<<" are not orthogonal"<<std::endl;
+    return false;
+}
+
+bool bch_matrices_bit_order(uint64_t n, uint64_t d, BitMatrix& g, BitMatrix& h, unsigned threads, bool verify)
+{
+    /*
+     * Generator and check matrices of the extended BCH code of length n+1,
+     * column i corresponds to the field element i.
+     */
+    uint64_t pow = length_degree(n);
+    GF2 field(pow);
+    threads = threads == 0 ? default_threads() : threads;
+    std::vector<uint64_t> powers(1, 0);
+    std::vector<uint64_t> leaders;
+    uint64_t k = n - coset_leaders(n, d, leaders);
+    powers.insert(powers.end(), leaders.begin(), leaders.end());
+    uint64_t indPowers = powers.size();
+    ++n;
+    // Values x^p for every column and leader. Columns are visited as alpha^e for
+    // e in a chunk of exponents, alpha^(e*p) steps to the next column by adding p
+    // to its exponent, so the inner loop is a table read per value
+    uint64_t num = field.get_num();
+    uint32_t* exps = new uint32_t[num];
+    parallel_for(num, threads, [&](unsigned, uint64_t begin, uint64_t end) {
+        uint64_t x = field.pow(2, int(begin));
+        for(uint64_t e=begin; e<end; ++e)
         {
-            h[i] ^= ((hgen & (uint128(1) << (hdeg-j))) >> (hdeg-j)) << (j + i);
+            exps[e] = uint32_t(x);
+            x = field.mul(x, 2);
         }
-    }
-    output<<"Gen matrix:\n";
-    for(uint64_t i=0; i<k; ++i)
+    });
+    uint32_t* vals = new uint32_t[n*indPowers];
+    for(uint64_t j=0; j<indPowers; ++j)
     {
-        for(uint64_t j=0; j<n; ++j)
-            output<<(g[i] & (uint128(1)<<j) ? 1 : 0)<<" ";
-        output<<"\n";
+        vals[j] = powers[j] == 0 ? 1 : 0;
     }
-    output<<"Check matrix:\n";
+    parallel_for(num, threads, [&](unsigned, uint64_t begin, uint64_t end) {
+        std::vector<uint64_t> cur(indPowers), step(indPowers);
+        for(uint64_t j=0; j<indPowers; ++j)
+        {
+            step[j] = powers[j] % num;
+            cur[j] = uint64_t((uint128)begin * step[j] % num);
+        }
+        for(uint64_t e=begin; e<end; ++e)
+        {
+            uint32_t* v = vals + uint64_t(exps[e])*indPowers;
+            for(uint64_t j=0; j<indPowers; ++j)
+            {
+                v[j] = exps[cur[j]];
+                cur[j] += step[j];
+                cur[j] = cur[j] >= num ? cur[j] - num : cur[j];
+            }
+        }
+    });
+    delete[] exps;
+    // Packing: every chunk owns whole words of the rows, so no two threads touch the
+    // same word. The values of 64 columns for one leader form a 64x64 bit block
+    // whose transpose holds the row words of its pow bit planes
+    BitMatrix h_buf(indPowers*pow, n);
+    uint64_t words = h_buf.get_words();
+    parallel_for(words, threads, [&](unsigned, uint64_t begin, uint64_t end) {
+        uint64_t block[64];
+        for(uint64_t w=begin; w<end; ++w)
+        {
+            uint64_t first = w*64;
+            uint64_t count = n - first < 64 ? n - first : 64;
+            for(uint64_t j=0; j<indPowers; ++j)
+            {
+                for(uint64_t i=0; i<count; ++i)
+                {
+                    block[i] = vals[(first + i)*indPowers + j];
+                }
+                for(uint64_t i=count; i<64; ++i)
+                {
+                    block[i] = 0;
+                }
+                transpose64(block);
+                for(uint64_t l=0; l<pow; ++l)
+                {
+                    h_buf.row(j*pow + l)[w] = block[l];
+                }
+            }
+        }
+    });
+    delete[] vals;
+    GaussianWorkspace w;
+    upperEchelonForm(h_buf);
+    gaussianElimination(h_buf, n-k, g, w);
+    h.resize(n-k, n);
     for(uint64_t i=0; i<n-k; ++i)
     {
-        for(uint64_t j=0; j<n; ++j)
-            output<<(h[i] & (uint128(1)<<j) ? 1 : 0)<<" ";
-        output<<"\n";
+        memcpy(h.row(i), h_buf.row(i), sizeof(uint64_t)*h.get_words());
     }
-    delete[] g;
-    delete[] h;
+    return !verify || verify_matrices(g, h, threads);
 }
 
-void build_bch_matrices_bit_order(uint64_t n, uint64_t d, std::ostream& output)
+static void xor_shifted(uint64_t* dst, uint64_t dst_words, const uint64_t* src, uint64_t src_words, uint64_t shift)
 {
-    if(__builtin_popcount(n+1) > 1)
+    /* dst ^= src << shift, bits shifted past dst_words words are dropped. */
+    uint64_t w = shift >> 6, s = shift & 63;
+    for(uint64_t j=0; j<src_words && w+j<dst_words; ++j)
     {
-        std::cerr << "Length is not a 2^m-1"<<std::endl;
-    }
-    uint64_t pow = 0;
-    uint128 tmp = n;
-    tmp += 1;
-    while(tmp > 0)
-    {
-        ++pow;
-        tmp >>= 1;
+        dst[w+j] ^= src[j] << s;
+        if(s != 0 && w+j+1 < dst_words)
+        {
+            dst[w+j+1] ^= src[j] >> (64 - s);
+        }
     }
-    --pow;
-    GF2 field(pow);
-    uint128 b = 2;
-    uint128 bpow = b;
-    uint128 gen = field.min_poly(b);
-    int *powers = new int[d];
-    powers[0] = 0;
-    powers[1] = 1;
-    int indPowers = 2;
-    for(uint64_t i=2; i<d; ++i)
+}
+
+static bool divides(const std::vector<uint64_t>& rem, uint64_t r, uint64_t n)
+{
+    /* rem = x^n mod g(x) is 1 exactly when g(x) divides x^n + 1. */
+    for(uint64_t w=0; w<rem.size(); ++w)
     {
-        bpow = field.mul(bpow, b);
-        uint128 tmp = lcm_poly(gen, field.min_poly(bpow));
-        if(tmp != gen)
+        if(rem[w] != (w == 0 && r != 0 ? 1 : 0))
         {
-            powers[indPowers++] = i;
+            std::cerr<<"Generator polynomial of degree "<<r<<" doesn't divide x^"<<n<<" + 1"<<std::endl;
+            return false;
         }
-        gen = tmp;
     }
-    tmp = gen;
-    uint64_t k = 0;
-    while(tmp > 0)
+    return true;
+}
+
+bool cyclic_matrices_systematic(uint64_t n, const std::vector<uint64_t>& gen, bool extended, BitMatrix& g, BitMatrix& h,
+                                bool verify, unsigned threads)
+{
+    /*
+     * Systematic matrices of the cyclic code of length n straight from its generator g(x)
+     * of degree r = n-k: row i of G is x^(r+i) + (x^(r+i) mod g(x)), so G = [P | I]
+     * and H = [I | P^T]. Every remainder is the previous one times x, one shift
+     * and a conditional XOR of g(x). The extended code gets the overall parity
+     * as column n and a check row [0 | parities of the rows of G | 1].
+     * The verification first takes the remainder left after the last row,
+     * x^n mod g(x), which is 1 only if g(x) divides x^n + 1, and then checks
+     * G H^T = 0 on the assembled matrices, as the bit order builder does.
+     */
+    uint64_t r = deg_poly(gen);
+    uint64_t k = n - r;
+    uint64_t len = extended ? n + 1 : n;
+    uint64_t rwords = (r + 63) >> 6;
+    std::vector<uint64_t> rem(rwords + 1, 0), low(rwords + 1, 0);
+    for(uint64_t i=0; i<rwords && i<gen.size(); ++i)
+    {
+        low[i] = gen[i];
+    }
+    if((r & 63) != 0)
     {
-        ++k;
-        tmp >>= 1;
+        low[rwords-1] &= (uint64_t(1) << (r & 63)) - 1;
     }
-    --k;
-    k = n - k;
-    uint128 hgen, res;
-    div_poly((uint128(1)<<n)+1, gen, hgen, res);
-    // output<<"Built a ("<<n<<", "<<k<<") coder with gen poly\n"
-    //       <<std::bitset<128>(gen) <<"\nand check poly\n"
-    //      <<std::bitset<128>(hgen)<<std::endl;
-    uint128* h = new uint128[indPowers*pow];
-    memset(h, 0, sizeof(uint128)*(indPowers*pow));
-    uint64_t elem = 0;
-    uint64_t temp;
-    ++n;
-    for(unsigned int i=0; i<n; ++i)
+    rem = low; // x^r mod g(x)
+    BitMatrix p(k, r);
+    BitMatrix parity(1, k);
+    for(uint64_t i=0; i<k; ++i)
     {
-        for(unsigned int j=0; j<indPowers; ++j)
+        uint64_t weight = 1;
+        for(uint64_t w=0; w<rwords; ++w)
+        {
+            p.row(i)[w] = rem[w];
+            weight += __builtin_popcountll(rem[w]);
+        }
+        parity.set(0, i, int(weight & 1));
+        uint64_t carry = r == 0 ? 0 : (rem[(r-1) >> 6] >> ((r-1) & 63)) & 1;
+        for(uint64_t w=rwords; w>1; --w)
         {
-            temp = field.pow(elem, powers[j]);
-            for(unsigned int l=0; l<pow; ++l)
+            rem[w-1] = (rem[w-1] << 1) | (rem[w-2] >> 63);
+        }
+        rem[0] <<= 1;
+        if((r & 63) != 0)
+        {
+            rem[rwords-1] &= (uint64_t(1) << (r & 63)) - 1;
+        }
+        if(carry)
+        {
+            for(uint64_t w=0; w<rwords; ++w)
             {
-                h[j*pow+l] ^= (temp & (uint128(1) << l)) ? uint128(1) << i : 0;
+                rem[w] ^= low[w];
             }
         }
-        ++elem;
-    }
-    int **h_buf = new int*[indPowers*pow];
-    for(uint64_t i=0; i < indPowers*pow; ++i) {
-      h_buf[i] = new int[n];
-      for (unsigned int j = 0; j < n; ++j) {
-        h_buf[i][j] = (h[i] & (uint128(1) << j) ? 1 : 0);
-      }
     }
-    int ***g = new int**;
-    upperEchelonForm(indPowers*pow, n, h_buf);
-    gaussianElimination(n-k, n, h_buf, g);
-    output<<"EBCH("<<n<<", "<<k<<")\n\n";
-    output<<n<<" "<<k<<"\n\n";
+    g.resize(k, len);
     for(uint64_t i=0; i<k; ++i)
     {
-      for(uint64_t j=0; j<n; ++j)
-        output<<(*g)[i][j]<<" ";
-      output<<"\n";
+        memcpy(g.row(i), p.row(i), sizeof(uint64_t)*rwords);
+        g.set(i, r+i, 1);
+        if(extended)
+        {
+            g.set(i, n, parity.get(0, i));
+        }
     }
-    output<<"\n";
-    for(uint64_t i=0; i<n-k; ++i)
+    BitMatrix pt;
+    transpose(p, pt);
+    h.resize(extended ? r + 1 : r, len);
+    for(uint64_t j=0; j<r; ++j)
     {
-        for(uint64_t j=0; j<n; ++j)
-            output<<h_buf[i][j]<<" ";
-        output<<"\n";
+        h.set(j, j, 1);
+        xor_shifted(h.row(j), h.get_words(), pt.row(j), pt.get_words(), r);
     }
-    delete[] h;
-    for(unsigned int i=0; i<indPowers*pow; ++i) {
-      delete[] h_buf[i];
+    if(extended)
+    {
+        xor_shifted(h.row(r), h.get_words(), parity.row(0), parity.get_words(), r);
+        h.set(r, n, 1);
+    }
+    if(!verify)
+    {
+        return true;
+    }
+    return divides(rem, r, n) && verify_matrices(g, h, threads == 0 ? default_threads() : threads);
+}
+
+static void print_matrices(const char* name, const BitMatrix& g, const BitMatrix& h, std::ostream& output)
+{
+    /* Both matrices are complete before output starts, so the rows are written on this thread. */
+    AsyncWriter writer(output, false);
+    uint64_t n = g.get_cols();
+    uint64_t k = g.get_rows();
+    writer.text(std::string(name) + "(" + std::to_string(n) + ", " + std::to_string(k) + ")\n\n" +
+                std::to_string(n) + " " + std::to_string(k) + "\n\n");
+    writer.rows(g);
+    writer.text("\n");
+    writer.rows(h);
+    writer.finish();
+}
+
+bool build_bch_matrices_bit_order(uint64_t n, uint64_t d, std::ostream& output)
+{
+    BitMatrix g, h;
+    if(!bch_matrices_bit_order(n, d, g, h))
+    {
+        return false;
+    }
+    print_matrices("EBCH", g, h, output);
+    return true;
+}
+
+bool bch_matrices_systematic(uint64_t n, uint64_t d, bool extended, BitMatrix& g, BitMatrix& h, bool verify,
+                             unsigned threads)
+{
+    return cyclic_matrices_systematic(n, bch_generator_poly(n, d), extended, g, h, verify, threads);
+}
+
+bool bch_sweep_systematic(uint64_t n, bool extended, std::vector<uint64_t>& gen, BitMatrix& g, BitMatrix& h,
+                          const std::function<void(uint64_t)>& emit, bool verify, unsigned threads)
+{
+    /*
+     * All narrow-sense BCH codes of length n, from the largest to the repetition code.
+     * The codes are nested, so the generator of the next code is the current one
+     * times the minimal polynomial of the next coset leader: the field is built once,
+     * every minimal polynomial is found once and multiplied into the running generator.
+     * For every distinct code gen, g and h are filled and emit(d) is called with the
+     * largest designed distance giving that code. Stops and returns false at the
+     * first code failing the verification, which is not emitted.
+     */
+    GF2 field(length_degree(n));
+    std::vector<bool> covered(n, false);
+    covered[0] = true; // Coset of 0 is never a root of a narrow-sense code
+    gen.assign(1, 1);
+    uint64_t elem = 1;
+    for(uint64_t i=1; i<n; ++i)
+    {
+        elem = field.mul(elem, 2); // alpha^i
+        if(covered[i])
+        {
+            continue;
+        }
+        uint64_t c = i;
+        do
+        {
+            covered[c] = true;
+            c = (2*c) % n;
+        } while(c != i);
+        uint128 mp = field.min_poly(elem);
+        std::vector<uint64_t> factor(2);
+        factor[0] = uint64_t(mp);
+        factor[1] = uint64_t(mp >> 64);
+        gen = mul_poly(gen, factor);
+        uint64_t d = i + 1;
+        while(d < n && covered[d])
+        {
+            ++d;
+        }
+        if(!cyclic_matrices_systematic(n, gen, extended, g, h, verify, threads))
+        {
+            return false;
+        }
+        emit(d);
     }
-    delete[] h_buf;
-    for(unsigned int i=0; i<k; ++i) {
-      delete[] (*g)[i];
+    return true;
+}
+
+bool build_bch_matrices_systematic(uint64_t n, uint64_t d, bool extended, std::ostream& output)
+{
+    BitMatrix g, h;
+    if(!bch_matrices_systematic(n, d, extended, g, h))
+    {
+        return false;
     }
-    delete[] (*g);
-    delete g;
-    delete[] powers;
+    print_matrices(extended ? "EBCH" : "BCH", g, h, output);
+    return true;
 }
@@ -0,0 +1,579 @@
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include "BCHDecoder.h"
+#include "Parallel.h"
+
+BCHWorkspace::BCHWorkspace(uint64_t t, uint64_t points)
+{
+    syn = errors = lambda = b = tmp = reg = nullptr;
+    fft_coeffs = fft_values = fft_scratch = nullptr;
+    resize(t, points);
+}
+
+void BCHWorkspace::resize(uint64_t t, uint64_t points)
+{
+    release();
+    this->t = t;
+    syn = new uint64_t[2*t+1];
+    errors = new uint64_t[t+1];
+    lambda = new uint64_t[2*t+1];
+    b = new uint64_t[2*t+1];
+    tmp = new uint64_t[2*t+1];
+    reg = new uint64_t[2*t+1];
+    fft_coeffs = points ? new uint64_t[points] : nullptr;
+    fft_values = points ? new uint64_t[points] : nullptr;
+    fft_scratch = points ? new uint64_t[points] : nullptr;
+}
+
+BCHWorkspace::~BCHWorkspace()
+{
+    release();
+}
+
+void BCHWorkspace::release()
+{
+    delete[] syn;
+    delete[] errors;
+    delete[] lambda;
+    delete[] b;
+    delete[] tmp;
+    delete[] reg;
+    delete[] fft_coeffs;
+    delete[] fft_values;
+    delete[] fft_scratch;
+    syn = errors = lambda = b = tmp = reg = nullptr;
+    fft_coeffs = fft_values = fft_scratch = nullptr;
+}
+
+static uint64_t field_pow_from_length(uint64_t n)
+{
+    if(__builtin_popcountll(n+1) > 1)
+    {
+        std::cerr << "Length is not a 2^m-1"<<std::endl;
+    }
+    uint64_t pow = 0;
+    uint64_t tmp = n + 1;
+    while(tmp > 1)
+    {
+        ++pow;
+        tmp >>= 1;
+    }
+    return pow;
+}
+
+// Chien search goes through the FFT from this many errors per field degree
+static const uint64_t FFT_CHIEN_RATIO = 1;
+// Syndromes of cyclic words go through the FFT from this many errors per field degree
+static const uint64_t FFT_SYNDROME_RATIO = 8;
+// Largest field degree the FFT plan is built for
+static const uint64_t FFT_MAX_DEG = 20;
+
+static bool use_fft(uint64_t m, uint64_t t)
+{
+    return m <= FFT_MAX_DEG && t >= FFT_CHIEN_RATIO*m;
+}
+
+BCHDecoder::BCHDecoder(uint64_t n, uint64_t d, bool bit_order):
+    field(field_pow_from_length(n)),
+    fft(use_fft(field.get_deg(), d > 1 ? (d-1)/2 : 0) ? new AdditiveFFT(field) : nullptr),
+    work(d > 1 ? (d-1)/2 : 0, fft ? fft->get_points() : 0)
+{
+    fft_chien = fft != nullptr;
+    num = field.get_num();
+    t = d > 1 ? (d-1)/2 : 0;
+    this->bit_order = bit_order;
+    len = bit_order ? n + 1 : n;
+    exps = new uint64_t[num];
+    lg = new uint64_t[num+1];
+    lg[0] = num;
+    uint64_t x = 1;
+    for(uint64_t i=0; i<num; ++i)
+    {
+        exps[i] = x;
+        lg[x] = i;
+        x = field.mul(x, 2);
+    }
+    logs = new uint64_t[len];
+    positions = new uint64_t[num];
+    for(uint64_t p=0; p<len; ++p)
+    {
+        logs[p] = bit_order ? lg[p] : p;
+    }
+    for(uint64_t i=0; i<num; ++i)
+    {
+        positions[i] = bit_order ? exps[i] : i;
+    }
+    // The power sums of the bit order layout are not values of the word polynomial
+    fft_syndromes = fft != nullptr && !bit_order && t >= FFT_SYNDROME_RATIO*field.get_deg();
+}
+
+void BCHDecoder::set_distance(uint64_t d)
+{
+    /*
+     * Switching to another designed distance of the same length: the field
+     * tables and an existing FFT plan are kept, only the scratch follows t.
+     */
+    t = d > 1 ? (d-1)/2 : 0;
+    fft_chien = use_fft(field.get_deg(), t);
+    if(fft_chien && fft == nullptr)
+    {
+        fft = new AdditiveFFT(field);
+    }
+    fft_syndromes = fft_chien && !bit_order && t >= FFT_SYNDROME_RATIO*field.get_deg();
+    work.resize(t, get_fft_points());
+}
+
+BCHDecoder::~BCHDecoder()
+{
+    delete[] exps;
+    delete[] lg;
+    delete[] logs;
+    delete[] positions;
+    delete fft;
+}
+
+inline uint64_t BCHDecoder::mul(uint64_t a, uint64_t b) const
+{
+    if(a == 0 || b == 0)
+    {
+        return 0;
+    }
+    uint64_t s = lg[a] + lg[b];
+    return exps[s >= num ? s - num : s];
+}
+
+void BCHDecoder::syndromes(const uint8_t* word, uint64_t* syn) const
+{
+    /* Syndromes S_j = sum of X^j over the ones of the word, syn[j-1] = S_j for j = 1..2t. */
+    memset(syn, 0, sizeof(uint64_t)*2*t);
+    for(uint64_t p=0; p<len; ++p)
+    {
+        if(!word[p] || logs[p] == num)
+        {
+            continue;
+        }
+        for(uint64_t j=1; j<2*t; j+=2)
+        {
+            syn[j-1] ^= exps[(logs[p]*j) % num];
+        }
+    }
+    // Binary word: S_2j = S_j^2
+    for(uint64_t j=1; j<=t; ++j)
+    {
+        syn[2*j-1] = mul(syn[j-1], syn[j-1]);
+    }
+}
+
+void BCHDecoder::syndromes(const uint8_t* word, uint64_t* syn, BCHWorkspace& w) const
+{
+    /* Same as above, for a long cyclic word S_j = r(alpha^j) is read off the FFT of r(x). */
+    if(!fft_syndromes || w.fft_values == nullptr)
+    {
+        syndromes(word, syn);
+        return;
+    }
+    uint64_t points = fft->get_points();
+    for(uint64_t p=0; p<len; ++p)
+    {
+        w.fft_coeffs[p] = word[p];
+    }
+    memset(w.fft_coeffs + len, 0, sizeof(uint64_t)*(points-len));
+    fft->evaluate(w.fft_coeffs, points, w.fft_values, w.fft_scratch);
+    for(uint64_t j=1; j<=2*t; ++j)
+    {
+        syn[j-1] = w.fft_values[exps[j % num]];
+    }
+}
+
+void BCHDecoder::flip_syndromes(uint64_t pos, uint64_t* syn) const
+{
+    /* Updating syndromes after flipping a single position. */
+    if(logs[pos] == num)
+    {
+        return;
+    }
+    for(uint64_t j=1; j<=2*t; ++j)
+    {
+        syn[j-1] ^= exps[(logs[pos]*j) % num];
+    }
+}
+
+int BCHDecoder::decode_syndromes(const uint64_t* syn, BCHWorkspace& w, uint64_t* errors) const
+{
+    /*
+     * Berlekamp-Massey and Chien search. Writes positions of the errors among
+     * the non-parity positions and returns their number, -1 if not decodable.
+     */
+    bool zero = true;
+    for(uint64_t j=0; j<2*t; ++j)
+    {
+        zero = zero && syn[j] == 0;
+    }
+    if(zero)
+    {
+        return 0;
+    }
+    uint64_t size = 2*t + 1;
+    memset(w.lambda, 0, sizeof(uint64_t)*size);
+    memset(w.b, 0, sizeof(uint64_t)*size);
+    w.lambda[0] = 1;
+    w.b[0] = 1;
+    uint64_t el = 0;
+    for(uint64_t r=1; r<=2*t; ++r)
+    {
+        uint64_t discr = 0;
+        for(uint64_t i=0; i<=el && i<r; ++i)
+        {
+            discr ^= mul(w.lambda[i], syn[r-i-1]);
+        }
+        if(discr == 0)
+        {
+            memmove(w.b + 1, w.b, sizeof(uint64_t)*(size-1));
+            w.b[0] = 0;
+            continue;
+        }
+        w.tmp[0] = w.lambda[0];
+        for(uint64_t i=1; i<size; ++i)
+        {
+            w.tmp[i] = w.lambda[i] ^ mul(discr, w.b[i-1]);
+        }
+        if(2*el <= r - 1)
+        {
+            el = r - el;
+            uint64_t inv = exps[(num - lg[discr]) % num];
+            for(uint64_t i=0; i<size; ++i)
+            {
+                w.b[i] = mul(w.lambda[i], inv);
+            }
+        }
+        else
+        {
+            memmove(w.b + 1, w.b, sizeof(uint64_t)*(size-1));
+            w.b[0] = 0;
+        }
+        memcpy(w.lambda, w.tmp, sizeof(uint64_t)*size);
+    }
+    uint64_t deg = 0;
+    for(uint64_t i=0; i<size; ++i)
+    {
+        if(w.lambda[i] != 0)
+        {
+            deg = i;
+        }
+    }
+    if(deg > t || deg != el)
+    {
+        return -1;
+    }
+    // Chien search: lambda(alpha^-i) == 0 means an error at locator alpha^i
+    if(fft_chien && w.fft_values != nullptr)
+    {
+        uint64_t flen = 1;
+        while(flen <= deg)
+        {
+            flen <<= 1;
+        }
+        memcpy(w.fft_coeffs, w.lambda, sizeof(uint64_t)*(deg+1));
+        memset(w.fft_coeffs + deg + 1, 0, sizeof(uint64_t)*(flen-deg-1));
+        fft->evaluate(w.fft_coeffs, flen, w.fft_values, w.fft_scratch);
+        uint64_t count = 0;
+        for(uint64_t i=0; i<num && count<deg; ++i)
+        {
+            if(w.fft_values[exps[i == 0 ? 0 : num - i]] == 0)
+            {
+                errors[count++] = positions[i];
+            }
+        }
+        return count == deg ? int(count) : -1;
+    }
+    for(uint64_t j=1; j<=deg; ++j)
+    {
+        w.reg[j] = lg[w.lambda[j]];
+    }
+    uint64_t count = 0;
+    for(uint64_t i=0; i<num && count<deg; ++i)
+    {
+        uint64_t q = w.lambda[0];
+        for(uint64_t j=1; j<=deg; ++j)
+        {
+            if(w.reg[j] != num)
+            {
+                q ^= exps[w.reg[j]];
+                w.reg[j] = w.reg[j] >= j ? w.reg[j] - j : w.reg[j] + num - j;
+            }
+        }
+        if(q == 0)
+        {
+            errors[count++] = positions[i];
+        }
+    }
+    return count == deg ? int(count) : -1;
+}
+
+int BCHDecoder::decode(uint8_t* word)
+{
+    /*
+     * Hard-decision decoding in place. Returns the number of corrected
+     * positions or -1 if the word is left untouched as not decodable.
+     */
+    uint64_t* errors = work.errors;
+    syndromes(word, work.syn, work);
+    int count = decode_syndromes(work.syn, work, errors);
+    if(count < 0)
+    {
+        return -1;
+    }
+    if(bit_order)
+    {
+        uint8_t parity = 0;
+        for(uint64_t p=0; p<len; ++p)
+        {
+            parity ^= word[p];
+        }
+        if((parity ^ (count & 1)) != 0)
+        {
+            if(uint64_t(count) == t)
+            {
+                return -1;
+            }
+            errors[count++] = 0;
+        }
+    }
+    for(int i=0; i<count; ++i)
+    {
+        word[errors[i]] ^= 1;
+    }
+    return count;
+}
+
+uint64_t BCHDecoder::get_len() const {
+    return len;
+}
+
+uint64_t BCHDecoder::get_t() const {
+    return t;
+}
+
+uint64_t BCHDecoder::get_fft_points() const {
+    return fft_chien ? fft->get_points() : 0;
+}
+
+bool BCHDecoder::is_bit_order() const {
+    return bit_order;
+}
+
+ChaseDecoder::ChaseDecoder(const BCHDecoder& dec, uint64_t flips, unsigned threads): dec(dec)
+{
+    uint64_t len = dec.get_len();
+    if(flips > len)
+    {
+        flips = len;
+    }
+    if(flips > 30)
+    {
+        std::cerr<<"Too many test positions for Chase decoding: "<<flips<<std::endl;
+        flips = 30;
+    }
+    this->flips = flips;
+    this->threads = threads == 0 ? 1 : threads;
+    order = new uint64_t[len];
+    rank = new int64_t[len];
+    hard = new uint8_t[len];
+    lane_best_num = new int[this->threads];
+    lane_best_pattern = new uint64_t[this->threads];
+    lane_best_metric = new float[this->threads];
+    lanes = new BCHWorkspace*[this->threads];
+    for(unsigned i=0; i<this->threads; ++i)
+    {
+        lanes[i] = new BCHWorkspace(0);
+    }
+    contrib = syn = lane_syn = lane_errors = lane_best = nullptr;
+    resize();
+}
+
+void ChaseDecoder::resize()
+{
+    /* Buffers that depend on t, reallocated when set_distance has changed it on the decoder. */
+    t = dec.get_t();
+    syn_len = 2*t;
+    delete[] contrib;
+    delete[] syn;
+    delete[] lane_syn;
+    delete[] lane_errors;
+    delete[] lane_best;
+    contrib = new uint64_t[flips*syn_len + 1];
+    syn = new uint64_t[syn_len + 1];
+    lane_syn = new uint64_t[threads*syn_len + 1];
+    lane_errors = new uint64_t[threads*(t+1)];
+    lane_best = new uint64_t[threads*(t+1)];
+    for(unsigned i=0; i<threads; ++i)
+    {
+        lanes[i]->resize(t, dec.get_fft_points());
+    }
+}
+
+ChaseDecoder::~ChaseDecoder()
+{
+    for(unsigned i=0; i<threads; ++i)
+    {
+        delete lanes[i];
+    }
+    delete[] lanes;
+    delete[] order;
+    delete[] rank;
+    delete[] hard;
+    delete[] contrib;
+    delete[] syn;
+    delete[] lane_syn;
+    delete[] lane_errors;
+    delete[] lane_best;
+    delete[] lane_best_num;
+    delete[] lane_best_pattern;
+    delete[] lane_best_metric;
+}
+
+void ChaseDecoder::run(unsigned lane, uint64_t begin, uint64_t end, const float* llr)
+{
+    /* Trying test patterns with Gray code indices [begin, end). */
+    uint64_t* s = lane_syn + lane*syn_len;
+    uint64_t* errors = lane_errors + lane*(t+1);
+    uint64_t* best = lane_best + lane*(t+1);
+    lane_best_num[lane] = -1;
+    memcpy(s, syn, sizeof(uint64_t)*syn_len);
+    uint64_t pattern = begin ^ (begin >> 1);
+    for(uint64_t f=0; f<flips; ++f)
+    {
+        if((pattern >> f) & 1)
+        {
+            for(uint64_t j=0; j<syn_len; ++j)
+            {
+                s[j] ^= contrib[f*syn_len+j];
+            }
+        }
+    }
+    for(uint64_t i=begin; i<end; ++i)
+    {
+        if(i != begin)
+        {
+            // Consecutive Gray codes differ in the lowest set bit of i
+            uint64_t f = __builtin_ctzll(i);
+            pattern ^= uint64_t(1) << f;
+            for(uint64_t j=0; j<syn_len; ++j)
+            {
+                s[j] ^= contrib[f*syn_len+j];
+            }
+        }
+        int count = dec.decode_syndromes(s, *lanes[lane], errors);
+        if(count < 0)
+        {
+            continue;
+        }
+        if(dec.is_bit_order() && ((hard_parity + __builtin_popcountll(pattern) + count) & 1))
+        {
+            errors[count++] = 0;
+        }
+        // Correlation discrepancy: reliabilities of the positions differing from the hard decision
+        float metric = 0;
+        for(uint64_t f=0; f<flips; ++f)
+        {
+            if((pattern >> f) & 1)
+            {
+                metric += std::fabs(llr[order[f]]);
+            }
+        }
+        for(int e=0; e<count; ++e)
+        {
+            int64_t r = rank[errors[e]];
+            bool flipped = r >= 0 && ((pattern >> r) & 1);
+            metric += flipped ? -std::fabs(llr[errors[e]]) : std::fabs(llr[errors[e]]);
+        }
+        if(lane_best_num[lane] < 0 || metric < lane_best_metric[lane])
+        {
+            lane_best_num[lane] = count;
+            lane_best_pattern[lane] = pattern;
+            lane_best_metric[lane] = metric;
+            memcpy(best, errors, sizeof(uint64_t)*count);
+        }
+    }
+}
+
+// Test patterns times code length below which a Chase search is not split between threads
+static const uint64_t CHASE_PARALLEL_WORK = uint64_t(1) << 17;
+
+int ChaseDecoder::decode(const float* llr, uint8_t* word)
+{
+    /*
+     * Decoding LLRs (positive means 0) into word, one bit per byte. Returns the
+     * number of positions changed against the hard decision, -1 if every test
+     * pattern failed and word holds the hard decision.
+     */
+    uint64_t len = dec.get_len();
+    if(dec.get_t() != t)
+    {
+        resize();
+    }
+    hard_parity = 0;
+    for(uint64_t p=0; p<len; ++p)
+    {
+        hard[p] = llr[p] < 0 ? 1 : 0;
+        hard_parity ^= hard[p];
+        order[p] = p;
+        rank[p] = -1;
+    }
+    std::partial_sort(order, order + flips, order + len, [llr](uint64_t a, uint64_t b) {
+        return std::fabs(llr[a]) < std::fabs(llr[b]);
+    });
+    dec.syndromes(hard, syn, *lanes[0]);
+    memset(contrib, 0, sizeof(uint64_t)*flips*syn_len);
+    for(uint64_t f=0; f<flips; ++f)
+    {
+        rank[order[f]] = int64_t(f);
+        dec.flip_syndromes(order[f], contrib + f*syn_len);
+    }
+    for(unsigned i=0; i<threads; ++i)
+    {
+        lane_best_num[i] = -1;
+    }
+    // Spawning threads costs tens of microseconds, small searches run on the calling thread
+    uint64_t patterns = uint64_t(1) << flips;
+    if(threads == 1 || patterns * len < CHASE_PARALLEL_WORK)
+    {
+        run(0, 0, patterns, llr);
+    }
+    else
+    {
+        parallel_for(patterns, threads, [this, llr](unsigned lane, uint64_t begin, uint64_t end) {
+            run(lane, begin, end, llr);
+        });
+    }
+    int best = -1;
+    for(unsigned i=0; i<threads; ++i)
+    {
+        if(lane_best_num[i] >= 0 && (best < 0 || lane_best_metric[i] < lane_best_metric[best]))
+        {
+            best = int(i);
+        }
+    }
+    memcpy(word, hard, len);
+    if(best < 0)
+    {
+        return -1;
+    }
+    for(uint64_t f=0; f<flips; ++f)
+    {
+        word[order[f]] ^= (lane_best_pattern[best] >> f) & 1;
+    }
+    const uint64_t* errors = lane_best + best*(t+1);
+    for(int e=0; e<lane_best_num[best]; ++e)
+    {
+        word[errors[e]] ^= 1;
+    }
+    int changed = 0;
+    for(uint64_t p=0; p<len; ++p)
+    {
+        changed += word[p] != hard[p];
+    }
+    return changed;
+}
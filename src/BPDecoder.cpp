@@ -0,0 +1,379 @@
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include "BPDecoder.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Messages are LLRs times 8, magnitudes entering a check node are clamped so
+// that the normalization product stays in 16 bits
+static const float LLR_SCALE = 8;
+static const int16_t MSG_MAX = 2047;
+
+#if defined(__AVX2__)
+typedef __m256i vec;
+static const uint64_t LANES = 16;
+static inline vec vload(const int16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+static inline void vstore(int16_t* p, vec x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+static inline vec vset(int16_t x) { return _mm256_set1_epi16(x); }
+static inline vec vadds(vec a, vec b) { return _mm256_adds_epi16(a, b); }
+static inline vec vsubs(vec a, vec b) { return _mm256_subs_epi16(a, b); }
+static inline vec vxor(vec a, vec b) { return _mm256_xor_si256(a, b); }
+static inline vec vor(vec a, vec b) { return _mm256_or_si256(a, b); }
+static inline vec vmin(vec a, vec b) { return _mm256_min_epi16(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm256_max_epi16(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm256_mullo_epi16(a, b); }
+static inline vec vshr4(vec a) { return _mm256_srai_epi16(a, 4); }
+static inline vec vsign(vec a) { return _mm256_srai_epi16(a, 15); }
+static inline vec vselect_eq(vec a, vec b, vec x, vec y)
+{
+    vec mask = _mm256_cmpeq_epi16(a, b);
+    return _mm256_or_si256(_mm256_and_si256(mask, x), _mm256_andnot_si256(mask, y));
+}
+#elif defined(__SSE2__)
+typedef __m128i vec;
+static const uint64_t LANES = 8;
+static inline vec vload(const int16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+static inline void vstore(int16_t* p, vec x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+static inline vec vset(int16_t x) { return _mm_set1_epi16(x); }
+static inline vec vadds(vec a, vec b) { return _mm_adds_epi16(a, b); }
+static inline vec vsubs(vec a, vec b) { return _mm_subs_epi16(a, b); }
+static inline vec vxor(vec a, vec b) { return _mm_xor_si128(a, b); }
+static inline vec vor(vec a, vec b) { return _mm_or_si128(a, b); }
+static inline vec vmin(vec a, vec b) { return _mm_min_epi16(a, b); }
+static inline vec vmax(vec a, vec b) { return _mm_max_epi16(a, b); }
+static inline vec vmul(vec a, vec b) { return _mm_mullo_epi16(a, b); }
+static inline vec vshr4(vec a) { return _mm_srai_epi16(a, 4); }
+static inline vec vsign(vec a) { return _mm_srai_epi16(a, 15); }
+static inline vec vselect_eq(vec a, vec b, vec x, vec y)
+{
+    vec mask = _mm_cmpeq_epi16(a, b);
+    return _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, y));
+}
+#else
+struct vec {
+    int16_t x;
+};
+static const uint64_t LANES = 1;
+static inline int16_t saturate(int x) { return int16_t(x > 32767 ? 32767 : (x < -32768 ? -32768 : x)); }
+static inline vec vload(const int16_t* p) { return vec{*p}; }
+static inline void vstore(int16_t* p, vec x) { *p = x.x; }
+static inline vec vset(int16_t x) { return vec{x}; }
+static inline vec vadds(vec a, vec b) { return vec{saturate(int(a.x) + b.x)}; }
+static inline vec vsubs(vec a, vec b) { return vec{saturate(int(a.x) - b.x)}; }
+static inline vec vxor(vec a, vec b) { return vec{int16_t(a.x ^ b.x)}; }
+static inline vec vor(vec a, vec b) { return vec{int16_t(a.x | b.x)}; }
+static inline vec vmin(vec a, vec b) { return vec{a.x < b.x ? a.x : b.x}; }
+static inline vec vmax(vec a, vec b) { return vec{a.x > b.x ? a.x : b.x}; }
+static inline vec vmul(vec a, vec b) { return vec{int16_t(a.x * b.x)}; }
+static inline vec vshr4(vec a) { return vec{int16_t(a.x >> 4)}; }
+static inline vec vsign(vec a) { return vec{int16_t(a.x < 0 ? -1 : 0)}; }
+static inline vec vselect_eq(vec a, vec b, vec x, vec y) { return a.x == b.x ? x : y; }
+#endif
+
+BPDecoder::BPDecoder(const BitMatrix& h, uint64_t batch, int iterations, float normalization, float offset)
+{
+    if(normalization <= 0 || normalization > 1)
+    {
+        std::cerr<<"Min-sum normalization is invalid: "<<normalization<<std::endl;
+        normalization = 1;
+    }
+    n = h.get_cols();
+    words = h.get_words();
+    this->batch = batch == 0 ? LANES : (batch + LANES - 1) / LANES * LANES;
+    this->iterations = iterations < 0 ? 0 : iterations;
+    norm = int16_t(std::lround(normalization * 16));
+    norm = norm == 0 ? 1 : norm;
+    long q = std::lround(offset * LLR_SCALE);
+    this->offset = int16_t(q < 0 ? 0 : (q > MSG_MAX ? MSG_MAX : q));
+    checks = 0;
+    row_start = nullptr;
+    edge_var = nullptr;
+    edge_capacity = 0;
+    c2v = nullptr;
+    channel = new int16_t[n*this->batch];
+    total = new int16_t[n*this->batch];
+    next = new int16_t[n*this->batch];
+    unsat = new int16_t[this->batch];
+    done = new uint8_t[this->batch];
+    set_check_matrix(h);
+}
+
+BPDecoder::~BPDecoder()
+{
+    delete[] row_start;
+    delete[] edge_var;
+    delete[] c2v;
+    delete[] channel;
+    delete[] total;
+    delete[] next;
+    delete[] unsat;
+    delete[] done;
+}
+
+void BPDecoder::set_check_matrix(const BitMatrix& h)
+{
+    /* Edge lists of the rows, the buffers only grow. */
+    if(h.get_cols() != n)
+    {
+        std::cerr<<"Check matrix has "<<h.get_cols()<<" columns instead of "<<n<<std::endl;
+        return;
+    }
+    if(h.get_rows() != checks || row_start == nullptr)
+    {
+        delete[] row_start;
+        checks = h.get_rows();
+        row_start = new uint64_t[checks+1];
+    }
+    uint64_t edges = 0;
+    for(uint64_t c=0; c<checks; ++c)
+    {
+        const uint64_t* row = h.row(c);
+        for(uint64_t w=0; w<words; ++w)
+        {
+            edges += __builtin_popcountll(row[w]);
+        }
+    }
+    if(edges > edge_capacity || edge_var == nullptr)
+    {
+        delete[] edge_var;
+        delete[] c2v;
+        edge_var = nullptr;
+        c2v = nullptr;
+        edge_capacity = edges;
+        edge_var = new uint64_t[edges+1];
+        c2v = new int16_t[(edges+1)*batch];
+    }
+    uint64_t e = 0;
+    for(uint64_t c=0; c<checks; ++c)
+    {
+        row_start[c] = e;
+        const uint64_t* row = h.row(c);
+        for(uint64_t w=0; w<words; ++w)
+        {
+            uint64_t bits = row[w];
+            while(bits != 0)
+            {
+                edge_var[e++] = (w << 6) + __builtin_ctzll(bits);
+                bits &= bits - 1;
+            }
+        }
+    }
+    row_start[checks] = e;
+}
+
+void BPDecoder::load_batch(const float* llr, uint64_t frames)
+{
+    /* Quantized channel LLRs, missing frames are padded with a reliable zero word. */
+    for(uint64_t f=0; f<batch; ++f)
+    {
+        for(uint64_t v=0; v<n; ++v)
+        {
+            int16_t q = MSG_MAX;
+            if(f < frames)
+            {
+                float x = llr[f*n + v] * LLR_SCALE;
+                q = x >= MSG_MAX ? MSG_MAX : (x <= -MSG_MAX ? -MSG_MAX : int16_t(std::lround(x)));
+            }
+            channel[v*batch + f] = q;
+        }
+        done[f] = f >= frames;
+    }
+    memcpy(total, channel, sizeof(int16_t)*n*batch);
+    memset(c2v, 0, sizeof(int16_t)*row_start[checks]*batch);
+}
+
+void BPDecoder::iterate()
+{
+    /*
+     * One flooding iteration. Every check node sees x = total - c2v on its
+     * edges, keeps the two smallest |x| and the product of signs and sends
+     * back the smaller magnitude among the other edges: min2 to the edge
+     * holding min1, min1 to the rest. Equal minima give min1 == min2, so no
+     * index is needed.
+     */
+    const vec zero = vset(0);
+    const vec max_msg = vset(MSG_MAX);
+    const vec factor = vset(norm);
+    const vec sub = vset(offset);
+    memcpy(next, channel, sizeof(int16_t)*n*batch);
+    for(uint64_t c=0; c<checks; ++c)
+    {
+        uint64_t first = row_start[c];
+        uint64_t last = row_start[c+1];
+        for(uint64_t f=0; f<batch; f+=LANES)
+        {
+            vec sgn = zero;
+            vec min1 = max_msg;
+            vec min2 = max_msg;
+            for(uint64_t e=first; e<last; ++e)
+            {
+                vec x = vsubs(vload(total + edge_var[e]*batch + f), vload(c2v + e*batch + f));
+                vec a = vmin(vmax(x, vsubs(zero, x)), max_msg);
+                sgn = vxor(sgn, x);
+                min2 = vmin(min2, vmax(min1, a));
+                min1 = vmin(min1, a);
+            }
+            vec m1 = vmax(vsubs(vshr4(vmul(min1, factor)), sub), zero);
+            vec m2 = vmax(vsubs(vshr4(vmul(min2, factor)), sub), zero);
+            for(uint64_t e=first; e<last; ++e)
+            {
+                int16_t* msg = c2v + e*batch + f;
+                int16_t* out = next + edge_var[e]*batch + f;
+                vec x = vsubs(vload(total + edge_var[e]*batch + f), vload(msg));
+                vec a = vmin(vmax(x, vsubs(zero, x)), max_msg);
+                vec m = vselect_eq(a, min1, m2, m1);
+                vec mask = vsign(vxor(sgn, x));
+                vec r = vsubs(vxor(m, mask), mask);
+                vstore(msg, r);
+                vstore(out, vadds(vload(out), r));
+            }
+        }
+    }
+    std::swap(total, next);
+}
+
+void BPDecoder::check()
+{
+    /* unsat[f] < 0 iff the hard decision of frame f violates a check, the sign bits are XORed along the rows. */
+    const vec zero = vset(0);
+    for(uint64_t f=0; f<batch; f+=LANES)
+    {
+        vstore(unsat + f, zero);
+    }
+    for(uint64_t c=0; c<checks; ++c)
+    {
+        for(uint64_t f=0; f<batch; f+=LANES)
+        {
+            vec p = zero;
+            for(uint64_t e=row_start[c]; e<row_start[c+1]; ++e)
+            {
+                p = vxor(p, vload(total + edge_var[e]*batch + f));
+            }
+            vstore(unsat + f, vor(vload(unsat + f), p));
+        }
+    }
+}
+
+void BPDecoder::store_frame(uint64_t f, uint64_t* codeword, float* posterior) const
+{
+    memset(codeword, 0, sizeof(uint64_t)*words);
+    for(uint64_t v=0; v<n; ++v)
+    {
+        int16_t x = total[v*batch + f];
+        codeword[v >> 6] |= uint64_t(x < 0 ? 1 : 0) << (v & 63);
+        if(posterior != nullptr)
+        {
+            posterior[v] = x / LLR_SCALE;
+        }
+    }
+}
+
+uint64_t BPDecoder::decode(const float* llr, uint64_t frames, uint64_t* codewords, uint8_t* valid, float* posterior)
+{
+    /*
+     * llr[f*n + v] is the LLR of position v of frame f, negative means 1. Writes
+     * frames packed codewords of words words each, valid[f] tells whether
+     * codeword f satisfies all checks and posterior gets the final LLRs.
+     * Returns the number of valid frames.
+     */
+    uint64_t count = 0;
+    for(uint64_t first=0; first<frames; first+=batch)
+    {
+        uint64_t size = frames - first < batch ? frames - first : batch;
+        load_batch(llr + first*n, size);
+        for(int it=0;; ++it)
+        {
+            check();
+            uint64_t left = 0;
+            for(uint64_t f=0; f<size; ++f)
+            {
+                if(!done[f] && unsat[f] >= 0)
+                {
+                    store_frame(f, codewords + (first+f)*words, posterior == nullptr ? nullptr : posterior + (first+f)*n);
+                    if(valid != nullptr)
+                    {
+                        valid[first+f] = 1;
+                    }
+                    done[f] = 1;
+                    ++count;
+                }
+                left += !done[f];
+            }
+            if(left == 0 || it == iterations)
+            {
+                break;
+            }
+            iterate();
+        }
+        for(uint64_t f=0; f<size; ++f)
+        {
+            if(!done[f])
+            {
+                store_frame(f, codewords + (first+f)*words, posterior == nullptr ? nullptr : posterior + (first+f)*n);
+                if(valid != nullptr)
+                {
+                    valid[first+f] = 0;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+uint64_t BPDecoder::get_batch() const
+{
+    return batch;
+}
+
+ABPDecoder::ABPDecoder(const BitMatrix& h, int rounds, int iterations, float damping, float normalization):
+    h(h), adapted(h), bp(h, 1, iterations, normalization)
+{
+    n = h.get_cols();
+    this->rounds = rounds < 1 ? 1 : rounds;
+    this->damping = damping;
+    order = new uint64_t[n];
+    pivots = new uint64_t[h.get_rows()];
+    llr = new float[n];
+    post = new float[n];
+}
+
+ABPDecoder::~ABPDecoder()
+{
+    delete[] order;
+    delete[] pivots;
+    delete[] llr;
+    delete[] post;
+}
+
+bool ABPDecoder::decode(const float* llr, uint64_t* codeword)
+{
+    /* Returns true if the codeword satisfies all checks, otherwise it is the last hard decision. */
+    memcpy(this->llr, llr, sizeof(float)*n);
+    for(int round=0; round<rounds; ++round)
+    {
+        std::iota(order, order + n, 0);
+        const float* cur = this->llr;
+        std::sort(order, order + n, [cur](uint64_t a, uint64_t b) {
+            return std::fabs(cur[a]) < std::fabs(cur[b]);
+        });
+        adapted = h;
+        reducedEchelonForm(adapted, order, pivots);
+        bp.set_check_matrix(adapted);
+        uint8_t ok = 0;
+        bp.decode(this->llr, 1, codeword, &ok, post);
+        if(ok)
+        {
+            return true;
+        }
+        for(uint64_t v=0; v<n; ++v)
+        {
+            this->llr[v] += damping * (post[v] - this->llr[v]);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include "BigInt.h"
+
+BigInt::BigInt(int64_t x)
+{
+    negative = x < 0;
+    uint64_t m = negative ? uint64_t(0) - uint64_t(x) : uint64_t(x);
+    while(m != 0)
+    {
+        mag.push_back(uint32_t(m));
+        m >>= 32;
+    }
+}
+
+BigInt BigInt::from_unsigned(uint64_t x)
+{
+    BigInt ans;
+    while(x != 0)
+    {
+        ans.mag.push_back(uint32_t(x));
+        x >>= 32;
+    }
+    return ans;
+}
+
+void BigInt::trim()
+{
+    while(!mag.empty() && mag.back() == 0)
+    {
+        mag.pop_back();
+    }
+    if(mag.empty())
+    {
+        negative = false;
+    }
+}
+
+int BigInt::cmp_mag(const BigInt& a) const
+{
+    if(mag.size() != a.mag.size())
+    {
+        return mag.size() < a.mag.size() ? -1 : 1;
+    }
+    for(size_t i=mag.size(); i-- > 0;)
+    {
+        if(mag[i] != a.mag[i])
+        {
+            return mag[i] < a.mag[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+void BigInt::add_mag(const BigInt& a)
+{
+    if(mag.size() < a.mag.size())
+    {
+        mag.resize(a.mag.size(), 0);
+    }
+    uint64_t carry = 0;
+    for(size_t i=0; i<mag.size(); ++i)
+    {
+        uint64_t s = uint64_t(mag[i]) + carry + (i < a.mag.size() ? a.mag[i] : 0);
+        mag[i] = uint32_t(s);
+        carry = s >> 32;
+    }
+    if(carry != 0)
+    {
+        mag.push_back(uint32_t(carry));
+    }
+}
+
+void BigInt::sub_mag(const BigInt& a)
+{
+    /* |this| -= |a|, requires |this| >= |a|. */
+    int64_t borrow = 0;
+    for(size_t i=0; i<mag.size(); ++i)
+    {
+        int64_t s = int64_t(mag[i]) - borrow - (i < a.mag.size() ? int64_t(a.mag[i]) : 0);
+        borrow = s < 0 ? 1 : 0;
+        mag[i] = uint32_t(s + (borrow << 32));
+    }
+    trim();
+}
+
+BigInt& BigInt::operator+=(const BigInt& a)
+{
+    if(negative == a.negative)
+    {
+        add_mag(a);
+    }
+    else if(cmp_mag(a) >= 0)
+    {
+        sub_mag(a);
+    }
+    else
+    {
+        BigInt tmp(a);
+        tmp.sub_mag(*this);
+        *this = tmp;
+    }
+    return *this;
+}
+
+BigInt& BigInt::operator-=(const BigInt& a)
+{
+    BigInt tmp(a);
+    if(!tmp.mag.empty())
+    {
+        tmp.negative = !tmp.negative;
+    }
+    return *this += tmp;
+}
+
+BigInt& BigInt::operator*=(int64_t x)
+{
+    bool neg = x < 0;
+    uint64_t m = neg ? uint64_t(0) - uint64_t(x) : uint64_t(x);
+    unsigned __int128 carry = 0;
+    for(size_t i=0; i<mag.size(); ++i)
+    {
+        unsigned __int128 p = (unsigned __int128)mag[i] * m + carry;
+        mag[i] = uint32_t(p);
+        carry = p >> 32;
+    }
+    while(carry != 0)
+    {
+        mag.push_back(uint32_t(carry));
+        carry >>= 32;
+    }
+    negative = negative != neg;
+    trim();
+    return *this;
+}
+
+BigInt& BigInt::operator>>=(uint64_t bits)
+{
+    /* Shift of the magnitude, exact division by 2^bits when the low bits are zero. */
+    size_t limbs = size_t(bits >> 5);
+    unsigned shift = unsigned(bits & 31);
+    if(limbs >= mag.size())
+    {
+        mag.clear();
+        trim();
+        return *this;
+    }
+    mag.erase(mag.begin(), mag.begin() + limbs);
+    if(shift != 0)
+    {
+        for(size_t i=0; i<mag.size(); ++i)
+        {
+            uint32_t hi = i+1 < mag.size() ? mag[i+1] : 0;
+            mag[i] = (mag[i] >> shift) | (hi << (32 - shift));
+        }
+    }
+    trim();
+    return *this;
+}
+
+uint32_t BigInt::div_small(uint32_t d)
+{
+    /* Division of the magnitude by d in place, returns the remainder. */
+    uint64_t rem = 0;
+    for(size_t i=mag.size(); i-- > 0;)
+    {
+        uint64_t cur = (rem << 32) | mag[i];
+        mag[i] = uint32_t(cur / d);
+        rem = cur % d;
+    }
+    trim();
+    return uint32_t(rem);
+}
+
+bool BigInt::operator==(const BigInt& a) const
+{
+    return negative == a.negative && mag == a.mag;
+}
+
+bool BigInt::is_zero() const
+{
+    return mag.empty();
+}
+
+bool BigInt::is_negative() const
+{
+    return negative;
+}
+
+std::string BigInt::to_string() const
+{
+    if(mag.empty())
+    {
+        return "0";
+    }
+    BigInt tmp(*this);
+    std::string ans;
+    while(!tmp.is_zero())
+    {
+        uint32_t part = tmp.div_small(1000000000);
+        for(int i=0; i<9; ++i)
+        {
+            ans.push_back(char('0' + part % 10));
+            part /= 10;
+        }
+    }
+    while(ans.size() > 1 && ans.back() == '0')
+    {
+        ans.pop_back();
+    }
+    if(negative)
+    {
+        ans.push_back('-');
+    }
+    std::reverse(ans.begin(), ans.end());
+    return ans;
+}
@@ -0,0 +1,305 @@
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "BitMatrix.h"
+#include "Parallel.h"
+
+BitMatrix::BitMatrix()
+{
+    rows = 0;
+    cols = 0;
+    words = 0;
+    capacity = 0;
+    data = nullptr;
+}
+
+BitMatrix::BitMatrix(uint64_t rows, uint64_t cols)
+{
+    capacity = 0;
+    data = nullptr;
+    resize(rows, cols);
+}
+
+BitMatrix::BitMatrix(const BitMatrix& x)
+{
+    rows = x.rows;
+    cols = x.cols;
+    words = x.words;
+    capacity = rows*words;
+    data = capacity == 0 ? nullptr : new uint64_t[capacity];
+    if(capacity != 0)
+    {
+        memcpy(data, x.data, sizeof(uint64_t)*capacity);
+    }
+}
+
+BitMatrix::~BitMatrix()
+{
+    delete[] data;
+}
+
+BitMatrix& BitMatrix::operator=(const BitMatrix& x)
+{
+    /* Copying reuses the allocated storage when it is large enough. */
+    if(this == &x)
+    {
+        return *this;
+    }
+    if(capacity < x.rows*x.words)
+    {
+        delete[] data;
+        capacity = x.rows*x.words;
+        data = new uint64_t[capacity];
+    }
+    rows = x.rows;
+    cols = x.cols;
+    words = x.words;
+    if(rows*words != 0)
+    {
+        memcpy(data, x.data, sizeof(uint64_t)*rows*words);
+    }
+    return *this;
+}
+
+void BitMatrix::resize(uint64_t rows, uint64_t cols)
+{
+    /* Resizing to a zero matrix, the storage is reallocated only if it grows. */
+    this->rows = rows;
+    this->cols = cols;
+    words = (cols + 63) >> 6;
+    if(capacity < rows*words)
+    {
+        delete[] data;
+        capacity = rows*words;
+        data = new uint64_t[capacity];
+    }
+    clear();
+}
+
+void BitMatrix::clear()
+{
+    if(data != nullptr)
+    {
+        memset(data, 0, sizeof(uint64_t)*rows*words);
+    }
+}
+
+uint64_t* BitMatrix::row(uint64_t i)
+{
+    return data + i*words;
+}
+
+const uint64_t* BitMatrix::row(uint64_t i) const
+{
+    return data + i*words;
+}
+
+int BitMatrix::get(uint64_t i, uint64_t j) const
+{
+    return int((data[i*words + (j >> 6)] >> (j & 63)) & 1);
+}
+
+void BitMatrix::set(uint64_t i, uint64_t j, int bit)
+{
+    uint64_t& w = data[i*words + (j >> 6)];
+    w = (w & ~(uint64_t(1) << (j & 63))) | (uint64_t(bit & 1) << (j & 63));
+}
+
+void BitMatrix::flip(uint64_t i, uint64_t j)
+{
+    data[i*words + (j >> 6)] ^= uint64_t(1) << (j & 63);
+}
+
+void BitMatrix::swap_rows(uint64_t i, uint64_t j)
+{
+    if(i == j)
+    {
+        return;
+    }
+    std::swap_ranges(row(i), row(i) + words, row(j));
+}
+
+void BitMatrix::swap_cols(uint64_t i, uint64_t j)
+{
+    if(i == j)
+    {
+        return;
+    }
+    uint64_t wi = i >> 6, wj = j >> 6;
+    uint64_t si = i & 63, sj = j & 63;
+    for(uint64_t r=0; r<rows; ++r)
+    {
+        uint64_t* a = data + r*words;
+        uint64_t diff = ((a[wi] >> si) ^ (a[wj] >> sj)) & 1;
+        a[wi] ^= diff << si;
+        a[wj] ^= diff << sj;
+    }
+}
+
+uint64_t BitMatrix::get_rows() const {
+    return rows;
+}
+
+uint64_t BitMatrix::get_cols() const {
+    return cols;
+}
+
+uint64_t BitMatrix::get_words() const {
+    return words;
+}
+
+void transpose64(uint64_t* a)
+{
+    /*
+     * In-place transpose of a 64x64 bit block, bit j of a[i] goes to bit i of a[j].
+     * Swaps the off-diagonal halves of 32x32, 16x16, ..., 1x1 sub-blocks.
+     */
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for(uint64_t j=32; j!=0; j>>=1, m^=m<<j)
+    {
+        for(uint64_t k=0; k<64; k=(k+j+1) & ~j)
+        {
+            uint64_t t = ((a[k] >> j) ^ a[k+j]) & m;
+            a[k+j] ^= t;
+            a[k] ^= t << j;
+        }
+    }
+}
+
+void transpose(const BitMatrix& a, BitMatrix& t, unsigned threads)
+{
+    /*
+     * t = a^T, done by 64x64 blocks. Every thread owns a range of 64-row strips
+     * of t, so writes never share a cache line; the strip of a row block is
+     * gathered from a column of words of a, which stays in cache for 64 rows.
+     */
+    t.resize(a.get_cols(), a.get_rows());
+    parallel_for(a.get_words(), threads, [&](unsigned, uint64_t begin, uint64_t end) {
+        uint64_t block[64];
+        for(uint64_t bj=begin; bj<end; ++bj)
+        {
+            uint64_t out = std::min<uint64_t>(64, a.get_cols() - 64*bj);
+            for(uint64_t bi=0; bi<t.get_words(); ++bi)
+            {
+                uint64_t count = std::min<uint64_t>(64, a.get_rows() - 64*bi);
+                for(uint64_t i=0; i<count; ++i)
+                {
+                    block[i] = a.row(64*bi + i)[bj];
+                }
+                for(uint64_t i=count; i<64; ++i)
+                {
+                    block[i] = 0;
+                }
+                transpose64(block);
+                for(uint64_t l=0; l<out; ++l)
+                {
+                    t.row(64*bj + l)[bi] = block[l];
+                }
+            }
+        }
+    });
+}
+
+// Method of Four Russians: rows of b are combined 8 at a time through tables of
+// their 256 sums, one table per byte of a word of a, so every word of a is read
+// once per column block. c is computed in tiles of M4RM_ROWS rows by M4RM_WORDS
+// words, the tile and the 8 tables stay in L2
+static const uint64_t M4RM_ROWS = 1024;
+static const uint64_t M4RM_WORDS = 8;
+
+bool multiply(const BitMatrix& a, const BitMatrix& b, BitMatrix& c, unsigned threads)
+{
+    /* c = a b over GF(2), threads take ranges of rows of c. On mismatched sizes c is left empty. */
+    if(a.get_cols() != b.get_rows())
+    {
+        std::cerr<<"Can't multiply "<<a.get_rows()<<" x "<<a.get_cols()<<" by "
+                 <<b.get_rows()<<" x "<<b.get_cols()<<" matrix"<<std::endl;
+        c.resize(0, 0);
+        return false;
+    }
+    c.resize(a.get_rows(), b.get_cols());
+    uint64_t inner = a.get_cols();
+    uint64_t words = c.get_words();
+    parallel_for(a.get_rows(), threads, [&](unsigned, uint64_t begin, uint64_t end) {
+        std::vector<uint64_t> tables(8 * 256 * M4RM_WORDS);
+        for(uint64_t rb=begin; rb<end; rb+=M4RM_ROWS)
+        {
+            uint64_t re = std::min(rb + M4RM_ROWS, end);
+            for(uint64_t cb=0; cb<words; cb+=M4RM_WORDS)
+            {
+                uint64_t cw = std::min(M4RM_WORDS, words - cb);
+                for(uint64_t aw=0; aw<a.get_words(); ++aw)
+                {
+                    // tables[t][x] = sum of the rows 64aw+8t+j of b with bit j set in x,
+                    // each from the entry without its lowest bit
+                    uint64_t bytes = std::min<uint64_t>(8, (inner - 64*aw + 7) / 8);
+                    for(uint64_t t=0; t<bytes; ++t)
+                    {
+                        uint64_t first = 64*aw + 8*t;
+                        uint64_t size = uint64_t(1) << std::min<uint64_t>(8, inner - first);
+                        uint64_t* table = tables.data() + t*256*cw;
+                        std::fill(table, table + cw, 0);
+                        for(uint64_t x=1; x<size; ++x)
+                        {
+                            const uint64_t* prev = table + (x & (x - 1))*cw;
+                            const uint64_t* row = b.row(first + __builtin_ctzll(x)) + cb;
+                            uint64_t* entry = table + x*cw;
+                            for(uint64_t w=0; w<cw; ++w)
+                            {
+                                entry[w] = prev[w] ^ row[w];
+                            }
+                        }
+                    }
+                    for(uint64_t i=rb; i<re; ++i)
+                    {
+                        uint64_t bits = a.row(i)[aw];
+                        uint64_t* out = c.row(i) + cb;
+                        for(uint64_t t=0; bits!=0; ++t, bits>>=8)
+                        {
+                            const uint64_t* entry = tables.data() + (t*256 + (bits & 255))*cw;
+                            for(uint64_t w=0; w<cw; ++w)
+                            {
+                                out[w] ^= entry[w];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+    return true;
+}
+
+bool is_orthogonal(const BitMatrix& g, const BitMatrix& h, unsigned threads, uint64_t seed)
+{
+    /*
+     * Checks G H^T = 0 by Freivalds' test: G (H^T X) for a random r x 64 matrix X.
+     * A nonzero G H^T passes with probability at most 2^-64, and the cost is two
+     * products with 64 columns instead of a k x r product. X is drawn from seed,
+     * so the same matrices always give the same answer.
+     */
+    if(g.get_cols() != h.get_cols())
+    {
+        return false;
+    }
+    std::mt19937_64 rng(seed);
+    BitMatrix x(h.get_rows(), 64);
+    for(uint64_t i=0; i<h.get_rows(); ++i)
+    {
+        x.row(i)[0] = rng();
+    }
+    BitMatrix ht, y, z;
+    transpose(h, ht, threads);
+    multiply(ht, x, y, threads);
+    multiply(g, y, z, threads);
+    for(uint64_t i=0; i<z.get_rows(); ++i)
+    {
+        if(z.row(i)[0] != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
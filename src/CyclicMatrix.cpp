@@ -0,0 +1,202 @@
+#include <iostream>
+#include <cstring>
+#include "CyclicMatrix.h"
+#include "GF.h"
+
+static uint64_t bit_window(const uint64_t* src, uint64_t size, int64_t pos)
+{
+    /* 64 coefficients of src starting at x^pos, zero outside of its size words. */
+    if(pos <= -64)
+    {
+        return 0;
+    }
+    if(pos < 0)
+    {
+        return size == 0 ? 0 : src[0] << (-pos);
+    }
+    uint64_t w = uint64_t(pos) >> 6, s = uint64_t(pos) & 63;
+    uint64_t lo = w < size ? src[w] >> s : 0;
+    uint64_t hi = s != 0 && w+1 < size ? src[w+1] << (64 - s) : 0;
+    return lo | hi;
+}
+
+static void extract(const uint64_t* src, uint64_t size, int64_t pos, uint64_t count, uint64_t* out)
+{
+    /* out = coefficients pos..pos+count-1 of src, packed, unused bits of the last word zero. */
+    uint64_t words = (count + 63) >> 6;
+    for(uint64_t w=0; w<words; ++w)
+    {
+        out[w] = bit_window(src, size, pos + int64_t(64*w));
+    }
+    if(count & 63)
+    {
+        out[words-1] &= (uint64_t(1) << (count & 63)) - 1;
+    }
+}
+
+static uint64_t weight(const uint64_t* a, uint64_t size)
+{
+    uint64_t ans = 0;
+    for(uint64_t i=0; i<size; ++i)
+    {
+        ans += __builtin_popcountll(a[i]);
+    }
+    return ans;
+}
+
+static void mul_into(const uint64_t* a, uint64_t an, const uint64_t* b, uint64_t bn, uint64_t* out)
+{
+    /* out = a(x) b(x) in an + bn words, one shifted copy of a per non-zero coefficient of b. */
+    memset(out, 0, sizeof(uint64_t)*(an + bn));
+    for(uint64_t i=0; i<bn; ++i)
+    {
+        for(uint64_t bits=b[i]; bits!=0; bits&=bits-1)
+        {
+            uint64_t shift = 64*i + __builtin_ctzll(bits);
+            uint64_t w = shift >> 6, s = shift & 63;
+            for(uint64_t j=0; j<an; ++j)
+            {
+                out[w+j] ^= a[j] << s;
+                if(s != 0)
+                {
+                    out[w+j+1] ^= a[j] >> (64 - s);
+                }
+            }
+        }
+    }
+}
+
+static void mul_sparse(const uint64_t* a, uint64_t an, const uint64_t* b, uint64_t bn, CyclicWorkspace& w)
+{
+    /* w.prod = a(x) b(x), walking the set bits of the sparser operand. */
+    w.reserve(an + bn);
+    if(weight(a, an) < weight(b, bn))
+    {
+        mul_into(b, bn, a, an, w.prod);
+    }
+    else
+    {
+        mul_into(a, an, b, bn, w.prod);
+    }
+}
+
+CyclicWorkspace::CyclicWorkspace()
+{
+    prod = nullptr;
+    size = 0;
+}
+
+CyclicWorkspace::~CyclicWorkspace()
+{
+    delete[] prod;
+}
+
+void CyclicWorkspace::reserve(uint64_t words)
+{
+    if(size < words)
+    {
+        delete[] prod;
+        prod = new uint64_t[words];
+        size = words;
+    }
+}
+
+CyclicMatrix::CyclicMatrix(): poly(1, 1), rev(1, 1)
+{
+    rows = 0;
+    cols = 0;
+    deg = 0;
+}
+
+CyclicMatrix::CyclicMatrix(const std::vector<uint64_t>& poly, uint64_t rows, uint64_t cols): poly(poly)
+{
+    deg = deg_poly(this->poly);
+    if(deg + rows > cols)
+    {
+        std::cerr<<"Rows of degree "<<deg<<" polynomial don't fit: "<<rows<<" x "<<cols<<std::endl;
+        rows = deg > cols ? 0 : cols - deg;
+    }
+    this->rows = rows;
+    this->cols = cols;
+    this->poly.resize(deg / 64 + 1);
+    rev.assign(deg / 64 + 1, 0);
+    for(uint64_t t=0; t<=deg; ++t)
+    {
+        uint64_t s = deg - t;
+        rev[t >> 6] |= ((this->poly[s >> 6] >> (s & 63)) & 1) << (t & 63);
+    }
+}
+
+int CyclicMatrix::get(uint64_t i, uint64_t j) const
+{
+    if(j < i || j - i > deg)
+    {
+        return 0;
+    }
+    uint64_t t = j - i;
+    return int((poly[t >> 6] >> (t & 63)) & 1);
+}
+
+void CyclicMatrix::row(uint64_t i, uint64_t* out) const
+{
+    /* Row i is p shifted by i, get_words() words. */
+    extract(poly.data(), poly.size(), -int64_t(i), cols, out);
+}
+
+void CyclicMatrix::row_block(uint64_t first, uint64_t count, uint64_t* out) const
+{
+    /* Rows first..first+count-1 one after another, as in BitMatrix. */
+    uint64_t words = get_words();
+    for(uint64_t i=0; i<count; ++i)
+    {
+        row(first + i, out + i*words);
+    }
+}
+
+void CyclicMatrix::col(uint64_t j, uint64_t* out) const
+{
+    /* Column j has bit i = p[j-i] = rev[deg-j+i], (rows + 63) / 64 words. */
+    extract(rev.data(), rev.size(), int64_t(deg) - int64_t(j), rows, out);
+}
+
+void CyclicMatrix::mul(const uint64_t* x, uint64_t* y, CyclicWorkspace& w) const
+{
+    /*
+     * y = x M for a row vector x of rows bits, i.e. the coefficients of x(x) p(x):
+     * encoding when M is the generator matrix. The product goes to the
+     * workspace, so repeated products allocate nothing.
+     */
+    uint64_t xwords = (rows + 63) >> 6;
+    mul_sparse(x, xwords, poly.data(), poly.size(), w);
+    extract(w.prod, xwords + poly.size(), 0, cols, y);
+}
+
+void CyclicMatrix::mul_transposed(const uint64_t* y, uint64_t* s, CyclicWorkspace& w) const
+{
+    /*
+     * s = M y^T for a word y of cols bits: s_i = sum_t p_t y_(i+t) is the
+     * coefficient of x^(deg+i) in y(x) rev(x). The syndrome when M is the check matrix.
+     */
+    mul_sparse(y, get_words(), rev.data(), rev.size(), w);
+    extract(w.prod, get_words() + rev.size(), int64_t(deg), rows, s);
+}
+
+const std::vector<uint64_t>& CyclicMatrix::get_poly() const
+{
+    return poly;
+}
+
+uint64_t CyclicMatrix::get_rows() const
+{
+    return rows;
+}
+
+uint64_t CyclicMatrix::get_cols() const
+{
+    return cols;
+}
+
+uint64_t CyclicMatrix::get_words() const
+{
+    return (cols + 63) >> 6;
+}
@@ -1,4 +1,8 @@
+#include <algorithm>
 #include "../include/GF.h"
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
 
 uint64_t mod(uint64_t a, uint64_t b)
 {
@@ -13,21 +17,47 @@ uint64_t mod(uint64_t a, uint64_t b)
 GF2::GF2(uint64_t pow)
 {
     /* Generating a log table using primitive polynomial. */
-    if(pow > 16 || pow < 2)
+    if(pow > 32 || pow < 2)
     {
         std::cerr<<"Pow for GF is invalid: "<<pow<<std::endl;
     }
     this->deg = pow;
     primitive = PRIMITIVE_POLYS[pow];
     num = ((uint64_t(1)<<pow)-1);
+    logs = nullptr;
+    index = nullptr;
+    if(pow > GF2_TABLE_MAX_DEG)
+    {
+        // No tables: memory stays flat, logs are found through the factorization of num
+        uint64_t rest = num;
+        for(uint64_t q=2; q*q<=rest; ++q)
+        {
+            if(rest % q == 0)
+            {
+                order_factors.push_back(q);
+                while(rest % q == 0)
+                {
+                    rest /= q;
+                }
+            }
+        }
+        if(rest > 1)
+        {
+            order_factors.push_back(rest);
+        }
+        return;
+    }
 
     logs = new std::pair<uint64_t, uint64_t>[num];
+    index = new uint64_t[num+1];
+    index[0] = 0;
     std::pair<uint64_t, uint64_t> gen;
     gen.first = 1;
     gen.second = 0;
     for(uint64_t i=0; i<num; ++i)
     {
         logs[i] = gen;
+        index[gen.first] = gen.second;
         ++gen.second;
         gen.first <<= 1;
         if((gen.first >> pow) == 1)
@@ -44,11 +74,177 @@ GF2::GF2(uint64_t pow)
 #endif
 }
 
+uint64_t GF2::reduce(uint64_t a) const
+{
+    /* Reducing a carry-less product: the part above x^m is folded back through the low terms of the sparse primitive polynomial. */
+    uint64_t mask = num;
+    uint64_t taps = primitive ^ (uint64_t(1) << deg);
+    while((a >> deg) != 0)
+    {
+        uint64_t hi = a >> deg;
+        a &= mask;
+        for(uint64_t t=taps; t!=0; t&=t-1)
+        {
+            a ^= hi << __builtin_ctzll(t);
+        }
+    }
+    return a;
+}
+
+uint64_t GF2::mul_large(uint64_t a, uint64_t b) const
+{
+    /* Carry-less multiplication of two elements of at most 32 bits and reduction. */
+#if defined(__PCLMUL__)
+    __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128(int64_t(a)), _mm_cvtsi64_si128(int64_t(b)), 0);
+    return reduce(uint64_t(_mm_cvtsi128_si64(p)));
+#else
+    uint64_t tab[16];
+    tab[0] = 0;
+    tab[1] = a;
+    for(int i=2; i<16; ++i)
+    {
+        tab[i] = (i & 1) ? tab[i-1] ^ a : tab[i >> 1] << 1;
+    }
+    uint64_t ans = 0;
+    for(int s=28; s>=0; s-=4)
+    {
+        ans = (ans << 4) ^ tab[(b >> s) & 15];
+    }
+    return reduce(ans);
+#endif
+}
+
+uint64_t GF2::pow_large(uint64_t a, uint64_t e) const
+{
+    uint64_t ans = 1;
+    while(e != 0)
+    {
+        if(e & 1)
+        {
+            ans = mul_large(ans, a);
+        }
+        a = mul_large(a, a);
+        e >>= 1;
+    }
+    return ans;
+}
+
+uint64_t GF2::inv_large(uint64_t a) const
+{
+    /*
+     * Itoh-Tsujii inversion: a^-1 = (a^(2^(m-1)-1))^2. b_k = a^(2^k-1) is built
+     * along the binary expansion of m-1 with b_2k = b_k^(2^k) * b_k and
+     * b_k+1 = b_k^2 * a, so only m-2 squarings and a few multiplications are needed.
+     */
+    uint64_t e = deg - 1;
+    int top = 63 - __builtin_clzll(e);
+    uint64_t b = a;
+    uint64_t k = 1;
+    for(int bit=top-1; bit>=0; --bit)
+    {
+        uint64_t c = b;
+        for(uint64_t i=0; i<k; ++i)
+        {
+            c = mul_large(c, c);
+        }
+        b = mul_large(c, b);
+        k <<= 1;
+        if((e >> bit) & 1)
+        {
+            b = mul_large(mul_large(b, b), a);
+            ++k;
+        }
+    }
+    return mul_large(b, b);
+}
+
+static uint64_t inverse_mod(uint64_t a, uint64_t m)
+{
+    /* Inverse of a modulo m by the extended Euclidean algorithm, gcd(a, m) = 1. */
+    int64_t t = 0, new_t = 1;
+    int64_t r = int64_t(m), new_r = int64_t(a % m);
+    while(new_r != 0)
+    {
+        int64_t q = r / new_r;
+        int64_t tmp = t - q*new_t;
+        t = new_t;
+        new_t = tmp;
+        tmp = r - q*new_r;
+        r = new_r;
+        new_r = tmp;
+    }
+    return uint64_t(t < 0 ? t + int64_t(m) : t);
+}
+
+uint64_t GF2::log_large(uint64_t a) const
+{
+    /*
+     * Discrete logarithm without tables: Pohlig-Hellman over the prime powers
+     * of num with baby-step giant-step inside every subgroup of prime order.
+     */
+    uint64_t x = 0; // log modulo the product of the processed prime powers
+    uint64_t modulus = 1;
+    for(uint64_t f=0; f<order_factors.size(); ++f)
+    {
+        uint64_t q = order_factors[f];
+        uint64_t qe = 1;
+        uint64_t e = 0;
+        while(num % (qe*q) == 0)
+        {
+            qe *= q;
+            ++e;
+        }
+        uint64_t gamma = pow_large(2, num / q); // Generator of the subgroup of order q
+        uint64_t steps = 1;
+        while(steps*steps < q)
+        {
+            ++steps;
+        }
+        std::vector<std::pair<uint64_t, uint64_t> > baby(steps);
+        uint64_t cur = 1;
+        for(uint64_t j=0; j<steps; ++j)
+        {
+            baby[j] = std::make_pair(cur, j);
+            cur = mul_large(cur, gamma);
+        }
+        std::sort(baby.begin(), baby.end());
+        uint64_t giant = inv_large(cur);
+        uint64_t xq = 0; // log modulo q^e
+        uint64_t qi = 1;
+        for(uint64_t i=0; i<e; ++i)
+        {
+            uint64_t shifted = mul_large(a, pow_large(2, (num - xq) % num));
+            uint64_t h = pow_large(shifted, num / (qi*q));
+            uint64_t digit = 0;
+            for(uint64_t g=0; g<=steps; ++g)
+            {
+                std::vector<std::pair<uint64_t, uint64_t> >::iterator it =
+                        std::lower_bound(baby.begin(), baby.end(), std::make_pair(h, uint64_t(0)));
+                if(it != baby.end() && it->first == h)
+                {
+                    digit = g*steps + it->second;
+                    break;
+                }
+                h = mul_large(h, giant);
+            }
+            xq += digit*qi;
+            qi *= q;
+        }
+        // Chinese remainder: x + modulus*t = xq (mod q^e)
+        uint64_t diff = (xq + qe - x % qe) % qe;
+        uint64_t t = uint64_t((uint128)diff * inverse_mod(modulus % qe, qe) % qe);
+        x += modulus*t;
+        modulus *= qe;
+    }
+    return x % num;
+}
+
 GF2::~GF2()
 {
     deg = 0;
     primitive = 0;
     delete[] logs;
+    delete[] index;
     num = 0;
 }
 
@@ -79,19 +275,16 @@ uint64_t GF2::mul(const uint64_t& a, const uint64_t& b) const
     {
         return 0;
     }
-    uint64_t deg1 = 0, deg2 = 0;
-    for(uint64_t i=0; i<num; ++i)
+    if(logs == nullptr)
     {
-        if(logs[i].first == a)
-        {
-            deg1 = logs[i].second;
-        }
-        if(logs[i].first == b)
-        {
-            deg2 = logs[i].second;
-        }
+        return mul_large(a, b);
+    }
+    uint64_t deg1 = index[a], deg2 = index[b];
+    uint64_t res = deg1 + deg2;
+    if(res >= num)
+    {
+        res -= num;
     }
-    uint64_t res = mod(deg1+deg2, num);
 #ifdef DEBUG
     std::cout<<"Deg of a: "<<deg1<<"; Deg of b: "<<deg2<<"; Deg of mult:"<<deg<<"; Num+1="<<num+1<<"\n";
 #endif
@@ -120,15 +313,12 @@ uint64_t GF2::pow(const uint64_t& a, int pow) const
     {
         return 0;
     }
-    uint64_t deg1 = 0;
-    for(uint64_t i=0; i<num; ++i)
+    if(logs == nullptr)
     {
-        if(logs[i].first == a)
-        {
-            deg1 = logs[i].second;
-        }
+        return pow_large(a, uint64_t(pow));
     }
-    uint64_t res = mod(deg1*pow, num);
+    uint64_t deg1 = index[a];
+    uint64_t res = (deg1 * uint64_t(pow)) % num;
 #ifdef DEBUG
     std::cout<<"Deg of a: "<<deg1<<"; Deg of b: "<<deg2<<"; Deg of mult:"<<deg<<"; Num+1="<<num+1<<"\n";
 #endif
@@ -145,16 +335,12 @@ uint64_t GF2::inv(const uint64_t& a) const
     {
         return 0;
     }
-    uint64_t a_pow = 0;
-    for(uint64_t i=0; i<num; ++i)
+    if(logs == nullptr)
     {
-        if(logs[i].first == a)
-        {
-            a_pow = logs[i].second;
-            break;
-        }
+        return inv_large(a);
     }
-    a_pow = num - a_pow;
+    uint64_t a_pow = index[a];
+    a_pow = a_pow == 0 ? 0 : num - a_pow;
     return logs[a_pow].first;
 }
 
@@ -206,6 +392,7 @@ GF2::GF2() {
     primitive = 0;
     num = 0;
     logs = nullptr;
+    index = nullptr;
 }
 
 bool GF2::is_in(const uint64_t& x) const {
@@ -217,14 +404,31 @@ uint64_t GF2::get_deg() const {
 }
 
 GF2& GF2::operator=(const GF2 &a) {
+    if(this == &a)
+    {
+        return *this;
+    }
     this->deg = a.deg;
     this->num = a.num;
     this->primitive = a.primitive;
     delete [] this->logs;
-    this->logs = new std::pair<uint64_t, uint64_t>[this->num];
-    for(uint64_t i=0; i<this->num; ++i)
-    {
-        this->logs[i] = a.logs[i];
+    delete [] this->index;
+    this->logs = nullptr;
+    this->index = nullptr;
+    this->order_factors = a.order_factors;
+    if(a.logs != nullptr)
+    {
+        this->logs = new std::pair<uint64_t, uint64_t>[this->num];
+        this->index = new uint64_t[this->num+1];
+        for(uint64_t i=0; i<this->num; ++i)
+        {
+            this->logs[i] = a.logs[i];
+        }
+        this->index[0] = 0;
+        for(uint64_t i=1; i<=this->num; ++i)
+        {
+            this->index[i] = a.index[i];
+        }
     }
     return *this;
 }
@@ -233,10 +437,22 @@ GF2::GF2(const GF2 &a) {
     deg = a.deg;
     num = a.num;
     primitive = a.primitive;
-    logs = new std::pair<uint64_t, uint64_t>[this->num];
-    for(uint64_t i=0; i<num; ++i)
+    order_factors = a.order_factors;
+    logs = nullptr;
+    index = nullptr;
+    if(a.logs != nullptr)
     {
-        logs[i] = a.logs[i];
+        logs = new std::pair<uint64_t, uint64_t>[this->num];
+        index = new uint64_t[this->num+1];
+        for(uint64_t i=0; i<num; ++i)
+        {
+            logs[i] = a.logs[i];
+        }
+        index[0] = 0;
+        for(uint64_t i=1; i<=num; ++i)
+        {
+            index[i] = a.index[i];
+        }
     }
 }
 
@@ -245,14 +461,11 @@ uint64_t GF2::get_elem_deg(uint64_t elem) const {
     {
         std::cerr<<"Can't get elem degree; x="<<elem<<" is not from GF(2^"<<deg<<")\n";
     }
-    for(uint64_t i=0; i<num; ++i)
+    if(elem == 0)
     {
-        if(logs[i].first == elem)
-        {
-            return logs[i].second;
-        }
+        return 0;
     }
-    return 0;
+    return logs == nullptr ? log_large(elem) : index[elem];
 }
 
 uint64_t GF2::get_num() const {
@@ -339,6 +552,87 @@ uint64_t deg_poly(uint64_t poly)
     return ans;
 }
 
+std::vector<uint64_t> mul_poly(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b)
+{
+    /* Shift-and-XOR product, one shifted copy of a per non-zero coefficient of b. */
+    std::vector<uint64_t> ans(a.size() + b.size(), 0);
+    for(uint64_t i=0; i<b.size(); ++i)
+    {
+        for(uint64_t bits=b[i]; bits!=0; bits&=bits-1)
+        {
+            uint64_t shift = 64*i + __builtin_ctzll(bits);
+            uint64_t w = shift >> 6, s = shift & 63;
+            for(uint64_t j=0; j<a.size(); ++j)
+            {
+                ans[w+j] ^= a[j] << s;
+                if(s != 0)
+                {
+                    ans[w+j+1] ^= a[j] >> (64 - s);
+                }
+            }
+        }
+    }
+    while(ans.size() > 1 && ans.back() == 0)
+    {
+        ans.pop_back();
+    }
+    return ans;
+}
+
+uint64_t deg_poly(const std::vector<uint64_t>& a)
+{
+    for(uint64_t i=a.size(); i>0; --i)
+    {
+        if(a[i-1] != 0)
+        {
+            return 64*(i-1) + 63 - __builtin_clzll(a[i-1]);
+        }
+    }
+    return 0;
+}
+
+void div_poly(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, std::vector<uint64_t>& q, std::vector<uint64_t>& r)
+{
+    /* Long division, one shifted copy of b per quotient bit, only the words of r under b are touched. */
+    uint64_t b_deg = deg_poly(b);
+    if(b_deg == 0 && (b.empty() || b[0] == 0))
+    {
+        std::cerr<<"Invalid division, b=0!\n";
+        return;
+    }
+    r = a;
+    if(r.empty())
+    {
+        r.assign(1, 0);
+    }
+    uint64_t r_deg = deg_poly(r);
+    q.assign(r_deg >= b_deg ? (r_deg - b_deg) / 64 + 1 : 1, 0);
+    uint64_t b_words = b_deg / 64 + 1;
+    for(uint64_t i=r_deg+1; i-- > b_deg;)
+    {
+        if(!((r[i >> 6] >> (i & 63)) & 1))
+        {
+            continue;
+        }
+        uint64_t shift = i - b_deg;
+        q[shift >> 6] |= uint64_t(1) << (shift & 63);
+        uint64_t w = shift >> 6, s = shift & 63;
+        for(uint64_t j=0; j<b_words; ++j)
+        {
+            r[w+j] ^= b[j] << s;
+            if(s != 0 && w+j+1 < r.size())
+            {
+                r[w+j+1] ^= b[j] >> (64 - s);
+            }
+        }
+    }
+    r.resize(b_deg / 64 + 1);
+    while(r.size() > 1 && r.back() == 0)
+    {
+        r.pop_back();
+    }
+}
+
 GF2X::GF2X(): deg(1), F(2) {
     c = new uint64_t[1];
     c[0] = 0;
@@ -543,10 +837,14 @@ GF2X GF2X::operator*(uint64_t x) const {
     return answer;
 }
 
-uint64_t GF2X::get_deg() {
+uint64_t GF2X::get_deg() const {
     return deg;
 }
 
+uint64_t GF2X::get_coeff(uint64_t i) const {
+    return i <= deg ? c[i] : 0;
+}
+
 uint64_t* GF2X::roots(uint64_t& num)
 {
     uint64_t alpha = 1;
@@ -143,3 +143,172 @@ int gaussianElimination(int k, int n, int **a, int ***x) {
 
   return n-r;
 }
+
+GaussianWorkspace::GaussianWorkspace() {
+  order = nullptr;
+  size = 0;
+}
+
+GaussianWorkspace::~GaussianWorkspace() {
+  delete[] order;
+}
+
+void GaussianWorkspace::reserve(uint64_t n) {
+  if(size < n)
+  {
+    delete[] order;
+    order = new uint64_t[n];
+    size = n;
+  }
+}
+
+int upperEchelonForm(BitMatrix& a) {
+  // Same as the int version, rows are packed into words
+  uint64_t k = a.get_rows();
+  uint64_t n = a.get_cols();
+  uint64_t words = a.get_words();
+  uint64_t r = 0;
+  uint64_t c = 0;
+  while(r < k && c < n)
+  {
+    uint64_t word = c >> 6;
+    uint64_t bit = uint64_t(1) << (c & 63);
+    uint64_t index = k;
+    for(uint64_t i=r; i<k; ++i)
+    {
+      if(a.row(i)[word] & bit)
+      {
+        index = i;
+        break;
+      }
+    }
+    if(index == k)
+    {
+      ++c;
+      continue;
+    }
+    a.swap_rows(index, r);
+    const uint64_t* pivot = a.row(r);
+    for(uint64_t i=r+1; i<k; ++i)
+    {
+      uint64_t* row = a.row(i);
+      if(row[word] & bit)
+      {
+        for(uint64_t j=word; j<words; ++j)
+        {
+          row[j] ^= pivot[j];
+        }
+      }
+    }
+    ++r;
+    ++c;
+  }
+  return int(r);
+}
+
+int gaussianElimination(const BitMatrix& a, uint64_t k, BitMatrix& x, GaussianWorkspace& w) {
+  // Basis of the solutions of the first k rows of a, same result as the int version
+  uint64_t n = a.get_cols();
+  uint64_t words = a.get_words();
+  w.a.resize(k, n);
+  for(uint64_t i=0; i<k; ++i)
+  {
+    memcpy(w.a.row(i), a.row(i), sizeof(uint64_t)*words);
+  }
+  w.reserve(n);
+  BitMatrix& newa = w.a;
+  uint64_t* order = w.order;
+  uint64_t r = upperEchelonForm(newa);
+  x.resize(n-r, n);
+  for(uint64_t i=0; i<n; ++i)
+  {
+    order[i] = i;
+  }
+  for(uint64_t i=0; i<n-r; ++i)
+  {
+    x.set(i, r+i, 1);
+  }
+  // Permuting columns so that pivots are on the diagonal
+  for(uint64_t i=0; i<r; ++i)
+  {
+    if(!newa.get(i, i))
+    {
+      for(uint64_t j=i+1; j<n; ++j)
+      {
+        if(newa.get(i, j))
+        {
+          std::swap(order[i], order[j]);
+          newa.swap_cols(i, j);
+          break;
+        }
+      }
+    }
+  }
+  // Computing basis of the solution, row i of newa is zero left of the diagonal
+  for(uint64_t i=r; i-- > 0;)
+  {
+    const uint64_t* row = newa.row(i);
+    for(uint64_t j=0; j<n-r; ++j)
+    {
+      const uint64_t* sol = x.row(j);
+      uint64_t parity = 0;
+      for(uint64_t l=0; l<words; ++l)
+      {
+        parity ^= row[l] & sol[l];
+      }
+      x.set(j, i, __builtin_popcountll(parity) & 1);
+    }
+  }
+  // Returning solution to original ordering of columns
+  for(uint64_t i=0; i<n; ++i)
+  {
+    while(i != order[i])
+    {
+      x.swap_cols(i, order[i]);
+      std::swap(order[i], order[order[i]]);
+    }
+  }
+  return int(n-r);
+}
+
+uint64_t reducedEchelonForm(BitMatrix& a, const uint64_t* order, uint64_t* pivots) {
+  // Reduced row echelon form taking columns in the given order, stops as soon as every row has a pivot
+  uint64_t k = a.get_rows();
+  uint64_t n = a.get_cols();
+  uint64_t words = a.get_words();
+  uint64_t r = 0;
+  for(uint64_t idx=0; idx<n && r<k; ++idx)
+  {
+    uint64_t c = order[idx];
+    uint64_t word = c >> 6;
+    uint64_t bit = uint64_t(1) << (c & 63);
+    uint64_t index = k;
+    for(uint64_t i=r; i<k; ++i)
+    {
+      if(a.row(i)[word] & bit)
+      {
+        index = i;
+        break;
+      }
+    }
+    if(index == k)
+    {
+      continue;
+    }
+    a.swap_rows(index, r);
+    const uint64_t* pivot = a.row(r);
+    for(uint64_t i=0; i<k; ++i)
+    {
+      uint64_t* row = a.row(i);
+      if(i != r && (row[word] & bit))
+      {
+        for(uint64_t j=0; j<words; ++j)
+        {
+          row[j] ^= pivot[j];
+        }
+      }
+    }
+    pivots[r++] = c;
+  }
+  return r;
+}
@@ -0,0 +1,192 @@
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "OSDDecoder.h"
+
+OSDDecoder::OSDDecoder(const BitMatrix& g, int order, uint64_t dmin): g(g), sys(g)
+{
+    if(order < 0 || order > 3)
+    {
+        std::cerr<<"OSD order is invalid: "<<order<<std::endl;
+        order = order < 0 ? 0 : 3;
+    }
+    n = g.get_cols();
+    k = g.get_rows();
+    words = g.get_words();
+    this->order = order;
+    this->dmin = dmin;
+    perm = new uint64_t[n];
+    pivots = new uint64_t[k];
+    rel = new float[n];
+    hard = new uint64_t[words];
+    acc = new uint64_t[(order+1)*words];
+    best = new uint64_t[words];
+}
+
+OSDDecoder::~OSDDecoder()
+{
+    delete[] perm;
+    delete[] pivots;
+    delete[] rel;
+    delete[] hard;
+    delete[] acc;
+    delete[] best;
+}
+
+float OSDDecoder::metric(const uint64_t* diff, float bound) const
+{
+    /* Sum of reliabilities of the positions set in diff, stops once it exceeds bound. */
+    float sum = 0;
+    for(uint64_t i=0; i<words; ++i)
+    {
+        uint64_t w = diff[i];
+        while(w != 0)
+        {
+            sum += rel[(i << 6) + __builtin_ctzll(w)];
+            w &= w - 1;
+        }
+        if(sum >= bound)
+        {
+            return sum;
+        }
+    }
+    return sum;
+}
+
+bool OSDDecoder::is_optimal() const
+{
+    /*
+     * Sufficient condition of maximum likelihood: any other codeword differs
+     * from the best one in at least dmin positions, so it pays at least the
+     * dmin - |D| smallest reliabilities among the positions where best agrees
+     * with the hard decision.
+     */
+    uint64_t differ = 0;
+    for(uint64_t i=0; i<words; ++i)
+    {
+        differ += __builtin_popcountll(best[i]);
+    }
+    if(differ >= dmin)
+    {
+        return false;
+    }
+    uint64_t need = dmin - differ;
+    float bound = 0;
+    for(uint64_t i=n; i-- > 0 && need > 0;)
+    {
+        uint64_t p = perm[i];
+        if(!((best[p >> 6] >> (p & 63)) & 1))
+        {
+            bound += rel[p];
+            --need;
+        }
+    }
+    return best_metric <= bound;
+}
+
+void OSDDecoder::consider(const uint64_t* diff, float info_cost)
+{
+    if(info_cost >= best_metric)
+    {
+        return;
+    }
+    float m = metric(diff, best_metric);
+    if(m < best_metric)
+    {
+        best_metric = m;
+        memcpy(best, diff, sizeof(uint64_t)*words);
+        optimal = dmin != 0 && is_optimal();
+    }
+}
+
+float OSDDecoder::decode(const float* llr, uint64_t* codeword)
+{
+    /*
+     * Decoding n LLRs (positive means 0) into a packed codeword.
+     * Returns the correlation discrepancy of the chosen codeword.
+     */
+    memset(hard, 0, sizeof(uint64_t)*words);
+    for(uint64_t i=0; i<n; ++i)
+    {
+        rel[i] = std::fabs(llr[i]);
+        hard[i >> 6] |= uint64_t(llr[i] < 0 ? 1 : 0) << (i & 63);
+        perm[i] = i;
+    }
+    std::sort(perm, perm + n, [this](uint64_t a, uint64_t b) {
+        return rel[a] > rel[b] || (rel[a] == rel[b] && a < b);
+    });
+    // Most reliable basis: elimination stops as soon as k independent positions are found
+    sys = g;
+    uint64_t rank = reducedEchelonForm(sys, perm, pivots);
+    // Order 0: re-encoding of the hard decisions on the basis
+    uint64_t* acc0 = acc;
+    memcpy(acc0, hard, sizeof(uint64_t)*words);
+    for(uint64_t r=0; r<rank; ++r)
+    {
+        uint64_t p = pivots[r];
+        if((hard[p >> 6] >> (p & 63)) & 1)
+        {
+            const uint64_t* row = sys.row(r);
+            for(uint64_t j=0; j<words; ++j)
+            {
+                acc0[j] ^= row[j];
+            }
+        }
+    }
+    best_metric = metric(acc0, INFINITY);
+    memcpy(best, acc0, sizeof(uint64_t)*words);
+    optimal = dmin != 0 && is_optimal();
+    // Flipping basis bits from the least reliable one, every candidate is one row XOR
+    // away from its parent and the search is cut once the flipped bits alone cost too much
+    uint64_t* acc1 = acc + words;
+    uint64_t* acc2 = acc + 2*words;
+    uint64_t* acc3 = acc + 3*words;
+    for(uint64_t i1=rank; order >= 1 && !optimal && i1-- > 0;)
+    {
+        float cost1 = rel[pivots[i1]];
+        if(cost1 >= best_metric)
+        {
+            break;
+        }
+        const uint64_t* row1 = sys.row(i1);
+        for(uint64_t j=0; j<words; ++j)
+        {
+            acc1[j] = acc0[j] ^ row1[j];
+        }
+        consider(acc1, cost1);
+        for(uint64_t i2=i1; order >= 2 && !optimal && i2-- > 0;)
+        {
+            float cost2 = cost1 + rel[pivots[i2]];
+            if(cost2 >= best_metric)
+            {
+                break;
+            }
+            const uint64_t* row2 = sys.row(i2);
+            for(uint64_t j=0; j<words; ++j)
+            {
+                acc2[j] = acc1[j] ^ row2[j];
+            }
+            consider(acc2, cost2);
+            for(uint64_t i3=i2; order >= 3 && !optimal && i3-- > 0;)
+            {
+                float cost3 = cost2 + rel[pivots[i3]];
+                if(cost3 >= best_metric)
+                {
+                    break;
+                }
+                const uint64_t* row3 = sys.row(i3);
+                for(uint64_t j=0; j<words; ++j)
+                {
+                    acc3[j] = acc2[j] ^ row3[j];
+                }
+                consider(acc3, cost3);
+            }
+        }
+    }
+    for(uint64_t j=0; j<words; ++j)
+    {
+        codeword[j] = best[j] ^ hard[j];
+    }
+    return best_metric;
+}
@@ -0,0 +1,38 @@
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+unsigned default_threads()
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+void parallel_for(uint64_t count, unsigned threads,
+                  const std::function<void(unsigned, uint64_t, uint64_t)>& body)
+{
+    /*
+     * Splitting [0, count) into contiguous chunks, body(thread, begin, end) is
+     * called once per chunk. The first chunk runs on the calling thread.
+     */
+    if(threads == 0)
+    {
+        threads = 1;
+    }
+    if(count < threads)
+    {
+        threads = count == 0 ? 1 : unsigned(count);
+    }
+    std::vector<std::thread> pool;
+    for(unsigned i=1; i<threads; ++i)
+    {
+        uint64_t begin = count * i / threads;
+        uint64_t end = count * (i + 1) / threads;
+        pool.emplace_back(body, i, begin, end);
+    }
+    body(0, 0, count / threads);
+    for(unsigned i=0; i<pool.size(); ++i)
+    {
+        pool[i].join();
+    }
+}
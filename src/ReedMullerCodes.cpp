@@ -1 +1,250 @@
+#include <iostream>
+#include <cstring>
+#include "ReedMullerCodes.h"
 
+static uint64_t get_bits(const uint64_t* a, uint64_t pos, uint64_t len)
+{
+    /* Reading len <= 64 bits starting from the bit pos. */
+    uint64_t word = pos >> 6;
+    uint64_t shift = pos & 63;
+    uint64_t ans = a[word] >> shift;
+    if(shift != 0 && shift + len > 64)
+    {
+        ans |= a[word+1] << (64 - shift);
+    }
+    return len == 64 ? ans : ans & ((uint64_t(1) << len) - 1);
+}
+
+uint64_t rm_dimension(int r, int m)
+{
+    /* Dimension of RM(r, m) is sum of binomials C(m, i) for i <= r. */
+    if(r < 0)
+    {
+        return 0;
+    }
+    uint64_t ans = 0;
+    uint64_t binom = 1;
+    for(int i=0; i<=r && i<=m; ++i)
+    {
+        ans += binom;
+        binom = binom * (m - i) / (i + 1);
+    }
+    return ans;
+}
+
+RMCoder::RMCoder(int r, int m)
+{
+    /* Invalid parameters are reported and clamped to 1 <= m <= 30, 0 <= r <= m, so the tables stay in range. */
+    if(m < 1 || m > 30 || r < 0 || r > m)
+    {
+        std::cerr<<"Invalid parameters for RM code: r="<<r<<", m="<<m<<std::endl;
+        m = m < 1 ? 1 : (m > 30 ? 30 : m);
+        r = r < 0 ? 0 : (r > m ? m : r);
+    }
+    this->r = r;
+    this->m = m;
+    n = uint64_t(1) << m;
+    dims = new uint64_t[(m+1)*(m+1)];
+    for(int i=0; i<=m; ++i)
+    {
+        for(int j=0; j<=m; ++j)
+        {
+            dims[i*(m+1)+j] = rm_dimension(i, j);
+        }
+    }
+    k = dim(this->r, m);
+    // Every recursion level keeps its own LLR buffer, so decoding allocates nothing
+    llrs = new float*[m+1];
+    llrs[0] = nullptr;
+    for(int l=1; l<=m; ++l)
+    {
+        llrs[l] = new float[uint64_t(1) << (l-1)];
+    }
+    bits = new uint8_t[n];
+}
+
+RMCoder::~RMCoder()
+{
+    for(int l=1; l<=m; ++l)
+    {
+        delete[] llrs[l];
+    }
+    delete[] llrs;
+    delete[] bits;
+    delete[] dims;
+}
+
+uint64_t RMCoder::dim(int r, int m) const
+{
+    if(r < 0)
+    {
+        return 0;
+    }
+    if(r > m)
+    {
+        r = m;
+    }
+    return dims[r*(this->m+1)+m];
+}
+
+uint64_t RMCoder::encode_word(int r, int m, const uint64_t* msg, uint64_t& pos) const
+{
+    /* Encoding RM(r, m) with m <= 6, the whole codeword fits into one word. */
+    uint64_t len = uint64_t(1) << m;
+    if(r < 0)
+    {
+        return 0;
+    }
+    if(r == 0)
+    {
+        uint64_t bit = get_bits(msg, pos++, 1);
+        return bit ? (len == 64 ? ~uint64_t(0) : (uint64_t(1) << len) - 1) : 0;
+    }
+    if(r >= m)
+    {
+        uint64_t ans = get_bits(msg, pos, len);
+        pos += len;
+        return ans;
+    }
+    uint64_t u = encode_word(r, m-1, msg, pos);
+    uint64_t v = encode_word(r-1, m-1, msg, pos);
+    return u | ((u ^ v) << (len >> 1));
+}
+
+void RMCoder::encode_words(int r, int m, const uint64_t* msg, uint64_t& pos, uint64_t* out) const
+{
+    /* Encoding RM(r, m) with m > 6 into 2^(m-6) words. */
+    uint64_t words = uint64_t(1) << (m - 6);
+    if(r < 0)
+    {
+        memset(out, 0, sizeof(uint64_t)*words);
+        return;
+    }
+    if(r == 0)
+    {
+        uint64_t fill = get_bits(msg, pos++, 1) ? ~uint64_t(0) : 0;
+        for(uint64_t i=0; i<words; ++i)
+        {
+            out[i] = fill;
+        }
+        return;
+    }
+    if(r >= m)
+    {
+        for(uint64_t i=0; i<words; ++i)
+        {
+            out[i] = get_bits(msg, pos, 64);
+            pos += 64;
+        }
+        return;
+    }
+    uint64_t half = words >> 1;
+    if(m == 7)
+    {
+        out[0] = encode_word(r, m-1, msg, pos);
+        out[1] = encode_word(r-1, m-1, msg, pos);
+    }
+    else
+    {
+        encode_words(r, m-1, msg, pos, out);
+        encode_words(r-1, m-1, msg, pos, out + half);
+    }
+    for(uint64_t i=0; i<half; ++i)
+    {
+        out[half+i] ^= out[i];
+    }
+}
+
+void RMCoder::encode(const uint64_t* msg, uint64_t* codeword) const
+{
+    /* Encoding k message bits into n codeword bits, no generator matrix is involved. */
+    uint64_t pos = 0;
+    if(m <= 6)
+    {
+        codeword[0] = encode_word(r, m, msg, pos);
+    }
+    else
+    {
+        encode_words(r, m, msg, pos, codeword);
+    }
+}
+
+void RMCoder::decode_rec(int r, int m, const float* y, uint8_t* out, uint64_t* msg, uint64_t pos)
+{
+    /*
+     * Recursive successive cancellation decoding of RM(r, m) from LLRs y.
+     * Decisions for the codeword go to out, message bits are written starting from pos.
+     */
+    uint64_t len = uint64_t(1) << m;
+    if(r == 0)
+    {
+        // Repetition code: ML decision by the sum of LLRs
+        float sum = 0;
+        for(uint64_t i=0; i<len; ++i)
+        {
+            sum += y[i];
+        }
+        uint8_t bit = sum < 0 ? 1 : 0;
+        memset(out, bit, len);
+        msg[pos >> 6] |= uint64_t(bit) << (pos & 63);
+        return;
+    }
+    if(r >= m)
+    {
+        // Full space: hard decisions are the message itself
+        for(uint64_t i=0; i<len; ++i)
+        {
+            out[i] = y[i] < 0 ? 1 : 0;
+            msg[(pos+i) >> 6] |= uint64_t(out[i]) << ((pos+i) & 63);
+        }
+        return;
+    }
+    uint64_t half = len >> 1;
+    float* child = llrs[m];
+    // v = u + (u+v): min-sum combination of both halves
+    for(uint64_t i=0; i<half; ++i)
+    {
+        float a = y[i], b = y[half+i];
+        float abs_a = a < 0 ? -a : a, abs_b = b < 0 ? -b : b;
+        float mag = abs_a < abs_b ? abs_a : abs_b;
+        child[i] = ((a < 0) != (b < 0)) ? -mag : mag;
+    }
+    decode_rec(r-1, m-1, child, out + half, msg, pos + dim(r, m-1));
+    // u is observed twice: directly and through (u+v) once v is known
+    for(uint64_t i=0; i<half; ++i)
+    {
+        child[i] = y[i] + (out[half+i] ? -y[half+i] : y[half+i]);
+    }
+    decode_rec(r, m-1, child, out, msg, pos);
+    for(uint64_t i=0; i<half; ++i)
+    {
+        out[half+i] ^= out[i];
+    }
+}
+
+void RMCoder::decode(const float* llr, uint64_t* msg, uint64_t* codeword)
+{
+    /*
+     * Decoding n LLRs (positive means 0) into k message bits and, if codeword
+     * is not null, into the n-bit codeword. Uses only preallocated buffers.
+     */
+    memset(msg, 0, sizeof(uint64_t)*((k + 63) >> 6));
+    decode_rec(r, m, llr, bits, msg, 0);
+    if(codeword != nullptr)
+    {
+        uint64_t words = (n + 63) >> 6;
+        memset(codeword, 0, sizeof(uint64_t)*words);
+        for(uint64_t i=0; i<n; ++i)
+        {
+            codeword[i >> 6] |= uint64_t(bits[i]) << (i & 63);
+        }
+    }
+}
+
+uint64_t RMCoder::get_n() const {
+    return n;
+}
+
+uint64_t RMCoder::get_k() const {
+    return k;
+}
@@ -0,0 +1,329 @@
+#include <iostream>
+#include <cstring>
+#include "ReedSolomonCodes.h"
+
+// Largest region multiplication table (in symbols) the encoder is allowed to build
+static const uint64_t MAX_REGION_TABLE = uint64_t(1) << 22;
+
+RSCoder::RSCoder(uint64_t n, uint64_t k, uint64_t m): field(m < 2 || m > 16 ? 2 : m)
+{
+    /*
+     * Invalid parameters leave an empty coder: is_valid() is false, encode does
+     * nothing and decode fails, no table is sized from them.
+     */
+    valid = true;
+    if(m < 2 || m > 16)
+    {
+        std::cerr<<"Symbol size for RS code is invalid: "<<m<<std::endl;
+        valid = false;
+    }
+    num = field.get_num();
+    if(valid && (n > num || k == 0 || k >= n))
+    {
+        std::cerr<<"Invalid RS code parameters: ("<<n<<", "<<k<<") over GF(2^"<<m<<")"<<std::endl;
+        valid = false;
+    }
+    this->n = valid ? n : 0;
+    this->k = valid ? k : 0;
+    nroots = this->n - this->k;
+    // Log and antilog tables, antilog is doubled so sums of logs need no reduction
+    exp_table = new uint16_t[2*num];
+    log_table = new uint16_t[num+1];
+    log_table[0] = 0;
+    uint64_t x = 1;
+    for(uint64_t i=0; i<num; ++i)
+    {
+        exp_table[i] = exp_table[i+num] = uint16_t(x);
+        log_table[x] = uint16_t(i);
+        x = field.mul(x, 2);
+    }
+    // g(x) = (x + alpha)(x + alpha^2)...(x + alpha^(n-k))
+    gen = new uint16_t[nroots+1];
+    memset(gen, 0, sizeof(uint16_t)*(nroots+1));
+    gen[0] = 1;
+    for(uint64_t i=1; i<=nroots; ++i)
+    {
+        uint16_t root = exp_table[i];
+        for(uint64_t j=i; j>0; --j)
+        {
+            gen[j] = gen[j-1] ^ mul(gen[j], root);
+        }
+        gen[0] = mul(gen[0], root);
+    }
+    // Region table: one row per feedback symbol, the LFSR step is a row XOR
+    region = nullptr;
+    if((num+1)*nroots <= MAX_REGION_TABLE)
+    {
+        region = new uint16_t[(num+1)*nroots];
+        for(uint64_t f=0; f<=num; ++f)
+        {
+            for(uint64_t j=0; j<nroots; ++j)
+            {
+                region[f*nroots+j] = mul(uint16_t(f), gen[nroots-1-j]);
+            }
+        }
+    }
+    syn = new uint16_t[nroots];
+    lambda = new uint16_t[nroots+1];
+    b = new uint16_t[nroots+1];
+    t = new uint16_t[nroots+1];
+    omega = new uint16_t[nroots];
+    reg = new uint64_t[nroots+1];
+    root_pos = new uint64_t[nroots];
+    root_inv = new uint64_t[nroots];
+    erased = new uint8_t[this->n + 1];
+    memset(erased, 0, this->n + 1);
+}
+
+RSCoder::~RSCoder()
+{
+    delete[] exp_table;
+    delete[] log_table;
+    delete[] gen;
+    delete[] region;
+    delete[] syn;
+    delete[] lambda;
+    delete[] b;
+    delete[] t;
+    delete[] omega;
+    delete[] reg;
+    delete[] root_pos;
+    delete[] root_inv;
+    delete[] erased;
+}
+
+inline uint16_t RSCoder::mul(uint16_t a, uint16_t b) const
+{
+    if(a == 0 || b == 0)
+    {
+        return 0;
+    }
+    return exp_table[log_table[a] + log_table[b]];
+}
+
+void RSCoder::encode(const uint16_t* data, uint16_t* parity) const
+{
+    /* Systematic encoding: parity = data(x) * x^(n-k) mod g(x), parity[0] is the highest coefficient. */
+    if(!valid)
+    {
+        return;
+    }
+    memset(parity, 0, sizeof(uint16_t)*nroots);
+    for(uint64_t i=0; i<k; ++i)
+    {
+        uint16_t fb = data[i] ^ parity[0];
+        memmove(parity, parity + 1, sizeof(uint16_t)*(nroots-1));
+        parity[nroots-1] = 0;
+        if(fb == 0)
+        {
+            continue;
+        }
+        if(region != nullptr)
+        {
+            const uint16_t* row = region + uint64_t(fb)*nroots;
+            for(uint64_t j=0; j<nroots; ++j)
+            {
+                parity[j] ^= row[j];
+            }
+        }
+        else
+        {
+            for(uint64_t j=0; j<nroots; ++j)
+            {
+                parity[j] ^= mul(fb, gen[nroots-1-j]);
+            }
+        }
+    }
+}
+
+int RSCoder::decode(uint16_t* codeword, const uint64_t* erasures, uint64_t num_erasures)
+{
+    /*
+     * Errors-and-erasures decoding in place. Erasures are given as symbol positions.
+     * Returns the number of corrected symbols or -1 if the word is not decodable
+     * or the erasures are invalid: more than n-k, out of range or repeated.
+     */
+    if(!valid || num_erasures > nroots)
+    {
+        return -1;
+    }
+    bool distinct = true;
+    for(uint64_t i=0; i<num_erasures && distinct; ++i)
+    {
+        distinct = erasures[i] < n && !erased[erasures[i]];
+        if(distinct)
+        {
+            erased[erasures[i]] = 1;
+        }
+    }
+    for(uint64_t i=0; i<num_erasures; ++i)
+    {
+        if(erasures[i] < n)
+        {
+            erased[erasures[i]] = 0;
+        }
+    }
+    if(!distinct)
+    {
+        return -1;
+    }
+    // Syndromes S_i = c(alpha^(i+1))
+    bool zero = true;
+    for(uint64_t i=0; i<nroots; ++i)
+    {
+        uint16_t s = 0;
+        uint64_t step = i + 1;
+        for(uint64_t p=0; p<n; ++p)
+        {
+            s = (s == 0 ? 0 : exp_table[log_table[s] + step]) ^ codeword[p];
+        }
+        syn[i] = s;
+        zero = zero && s == 0;
+    }
+    if(zero)
+    {
+        return 0;
+    }
+    // Erasure locator (1 + X_1 x)...(1 + X_r x), X = alpha^(n-1-p)
+    memset(lambda, 0, sizeof(uint16_t)*(nroots+1));
+    lambda[0] = 1;
+    for(uint64_t i=0; i<num_erasures; ++i)
+    {
+        uint16_t x = exp_table[n-1-erasures[i]];
+        for(uint64_t j=i+1; j>0; --j)
+        {
+            lambda[j] ^= mul(lambda[j-1], x);
+        }
+    }
+    memcpy(b, lambda, sizeof(uint16_t)*(nroots+1));
+    // Berlekamp-Massey initialized with the erasure locator
+    uint64_t el = num_erasures;
+    for(uint64_t r=num_erasures+1; r<=nroots; ++r)
+    {
+        uint16_t discr = 0;
+        for(uint64_t i=0; i<r; ++i)
+        {
+            discr ^= mul(lambda[i], syn[r-i-1]);
+        }
+        if(discr == 0)
+        {
+            memmove(b + 1, b, sizeof(uint16_t)*nroots);
+            b[0] = 0;
+            continue;
+        }
+        t[0] = lambda[0];
+        for(uint64_t i=0; i<nroots; ++i)
+        {
+            t[i+1] = lambda[i+1] ^ mul(discr, b[i]);
+        }
+        if(2*el <= r + num_erasures - 1)
+        {
+            el = r + num_erasures - el;
+            uint16_t inv = exp_table[num - log_table[discr]];
+            for(uint64_t i=0; i<=nroots; ++i)
+            {
+                b[i] = mul(lambda[i], inv);
+            }
+        }
+        else
+        {
+            memmove(b + 1, b, sizeof(uint16_t)*nroots);
+            b[0] = 0;
+        }
+        memcpy(lambda, t, sizeof(uint16_t)*(nroots+1));
+    }
+    uint64_t deg_lambda = 0;
+    for(uint64_t i=0; i<=nroots; ++i)
+    {
+        if(lambda[i] != 0)
+        {
+            deg_lambda = i;
+        }
+    }
+    // Chien search over the positions of the (possibly shortened) code
+    for(uint64_t j=1; j<=deg_lambda; ++j)
+    {
+        reg[j] = lambda[j] == 0 ? num : (log_table[lambda[j]] + j*(num - (n-1))) % num;
+    }
+    uint64_t count = 0;
+    for(uint64_t p=0; p<n; ++p)
+    {
+        uint16_t q = lambda[0];
+        for(uint64_t j=1; j<=deg_lambda; ++j)
+        {
+            if(reg[j] != num)
+            {
+                q ^= exp_table[reg[j]];
+                reg[j] += j;
+                reg[j] = reg[j] >= num ? reg[j] - num : reg[j];
+            }
+        }
+        if(q == 0)
+        {
+            if(count == deg_lambda)
+            {
+                return -1;
+            }
+            root_pos[count] = p;
+            root_inv[count] = (num - (n-1-p)) % num;
+            ++count;
+        }
+    }
+    if(count != deg_lambda)
+    {
+        return -1;
+    }
+    // Errata evaluator omega = S * lambda mod x^(n-k)
+    for(uint64_t i=0; i<nroots; ++i)
+    {
+        uint16_t o = 0;
+        for(uint64_t j=0; j<=i && j<=deg_lambda; ++j)
+        {
+            o ^= mul(syn[i-j], lambda[j]);
+        }
+        omega[i] = o;
+    }
+    // Forney: e = omega(X^-1) / lambda'(X^-1)
+    for(uint64_t i=0; i<count; ++i)
+    {
+        uint64_t xinv = root_inv[i];
+        uint16_t num1 = 0;
+        for(uint64_t j=0; j<nroots; ++j)
+        {
+            if(omega[j] != 0)
+            {
+                num1 ^= exp_table[(log_table[omega[j]] + j*xinv) % num];
+            }
+        }
+        uint16_t den = 0;
+        for(uint64_t j=1; j<=deg_lambda; j+=2)
+        {
+            if(lambda[j] != 0)
+            {
+                den ^= exp_table[(log_table[lambda[j]] + (j-1)*xinv) % num];
+            }
+        }
+        if(den == 0)
+        {
+            return -1;
+        }
+        t[i] = num1 == 0 ? 0 : exp_table[log_table[num1] + num - log_table[den]];
+    }
+    for(uint64_t i=0; i<count; ++i)
+    {
+        codeword[root_pos[i]] ^= t[i];
+    }
+    return int(count);
+}
+
+bool RSCoder::is_valid() const {
+    return valid;
+}
+
+uint64_t RSCoder::get_n() const {
+    return n;
+}
+
+uint64_t RSCoder::get_k() const {
+    return k;
+}
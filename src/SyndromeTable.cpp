@@ -0,0 +1,259 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SyndromeTable.h"
+#include "Parallel.h"
+
+// Header of a saved table: magic, n, r, t, followed by the rows of H and the table
+static const uint64_t TABLE_MAGIC = 0x4c42545359484342ULL;
+static const uint64_t HEADER_WORDS = 4;
+
+SyndromeTable::SyndromeTable(const BitMatrix& h, uint64_t t, unsigned threads): h(h)
+{
+    n = h.get_cols();
+    r = h.get_rows();
+    this->t = t;
+    mapping = nullptr;
+    mapping_size = 0;
+    table = nullptr;
+    if(r > MAX_SYNDROME_BITS || n >= UNKNOWN || t == 0)
+    {
+        std::cerr<<"Can't build syndrome table for n="<<n<<", n-k="<<r<<", t="<<t<<std::endl;
+        return;
+    }
+    uint64_t size = (uint64_t(1) << r)*t;
+    table = new uint16_t[size];
+    for(uint64_t i=0; i<size; ++i)
+    {
+        table[i] = EMPTY;
+    }
+    for(uint64_t s=1; s < (uint64_t(1) << r); ++s)
+    {
+        table[s*t] = UNKNOWN;
+    }
+    if(threads == 0)
+    {
+        threads = default_threads();
+    }
+    // Syndromes of single positions are the columns of H
+    std::vector<uint64_t> cols(n, 0);
+    for(uint64_t i=0; i<r; ++i)
+    {
+        for(uint64_t j=0; j<n; ++j)
+        {
+            cols[j] |= uint64_t(h.get(i, j)) << i;
+        }
+    }
+    // Lighter leaders are placed first, a syndrome keeps the first leader that claims it
+    for(uint64_t w=1; w<=t; ++w)
+    {
+        fill(w, cols, threads);
+    }
+}
+
+void SyndromeTable::fill(uint64_t weight, const std::vector<uint64_t>& cols, unsigned threads)
+{
+    /* Enumerating error patterns of the given weight, threads take interleaved first positions. */
+    parallel_for(threads, threads, [this, weight, threads, &cols](unsigned lane, uint64_t, uint64_t) {
+        std::vector<uint64_t> pos(weight), syn(weight);
+        for(uint64_t first=lane; first+weight<=n; first+=threads)
+        {
+            // Odometer over the remaining positions, syn[l] is the syndrome of pos[0..l]
+            pos[0] = first;
+            syn[0] = cols[first];
+            uint64_t l = 0;
+            while(true)
+            {
+                if(l + 1 == weight)
+                {
+                    uint16_t* entry = table + syn[l]*t;
+                    uint16_t expected = UNKNOWN;
+                    if(__atomic_compare_exchange_n(entry, &expected, uint16_t(pos[0]), false,
+                                                   __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                    {
+                        for(uint64_t i=1; i<weight; ++i)
+                        {
+                            entry[i] = uint16_t(pos[i]);
+                        }
+                    }
+                    // Next pattern: advance the deepest position that can still move
+                    while(l > 0 && pos[l] + 1 + (weight - 1 - l) >= n)
+                    {
+                        --l;
+                    }
+                    if(l == 0)
+                    {
+                        break;
+                    }
+                    ++pos[l];
+                    syn[l] = syn[l-1] ^ cols[pos[l]];
+                }
+                else
+                {
+                    ++l;
+                    pos[l] = pos[l-1] + 1;
+                    syn[l] = syn[l-1] ^ cols[pos[l]];
+                }
+            }
+        }
+    });
+}
+
+SyndromeTable::SyndromeTable(const char* path, const BitMatrix* code)
+{
+    /*
+     * Mapping a table saved with save(). The header is checked before anything
+     * else is read: 1 <= r <= MAX_SYNDROME_BITS, r <= n < UNKNOWN, 1 <= t <= n
+     * and the file size must be the one the header gives. With code given the
+     * table must have been built from that check matrix.
+     */
+    table = nullptr;
+    mapping = nullptr;
+    mapping_size = 0;
+    n = r = t = 0;
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        std::cerr<<"Can't open syndrome table "<<path<<std::endl;
+        return;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || uint64_t(st.st_size) < HEADER_WORDS*sizeof(uint64_t))
+    {
+        std::cerr<<"Invalid syndrome table "<<path<<std::endl;
+        close(fd);
+        return;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        std::cerr<<"Can't map syndrome table "<<path<<std::endl;
+        return;
+    }
+    const uint64_t* header = (const uint64_t*)map;
+    bool valid = header[0] == TABLE_MAGIC && header[2] >= 1 && header[2] <= MAX_SYNDROME_BITS &&
+                 header[2] <= header[1] && header[1] < UNKNOWN && header[3] >= 1 && header[3] <= header[1];
+    // The bounds above keep the expected size far from overflowing
+    uint64_t words = (header[1] + 63) >> 6;
+    if(valid)
+    {
+        uint64_t expected = (HEADER_WORDS + header[2]*words)*sizeof(uint64_t)
+                            + (uint64_t(1) << header[2])*header[3]*sizeof(uint16_t);
+        valid = uint64_t(st.st_size) == expected;
+    }
+    if(valid && code != nullptr)
+    {
+        valid = header[1] == code->get_cols() && header[2] == code->get_rows();
+        for(uint64_t i=0; i<header[2] && valid; ++i)
+        {
+            valid = memcmp(code->row(i), header + HEADER_WORDS + i*words, sizeof(uint64_t)*words) == 0;
+        }
+    }
+    if(!valid)
+    {
+        std::cerr<<"Invalid syndrome table "<<path<<std::endl;
+        munmap(map, st.st_size);
+        return;
+    }
+    mapping = map;
+    mapping_size = st.st_size;
+    n = header[1];
+    r = header[2];
+    t = header[3];
+    h.resize(r, n);
+    for(uint64_t i=0; i<r; ++i)
+    {
+        memcpy(h.row(i), header + HEADER_WORDS + i*words, sizeof(uint64_t)*words);
+    }
+    table = (uint16_t*)(header + HEADER_WORDS + r*words);
+}
+
+SyndromeTable::~SyndromeTable()
+{
+    if(mapping != nullptr)
+    {
+        munmap(mapping, mapping_size);
+    }
+    else
+    {
+        delete[] table;
+    }
+}
+
+bool SyndromeTable::save(const char* path) const
+{
+    if(table == nullptr)
+    {
+        return false;
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    uint64_t header[HEADER_WORDS] = {TABLE_MAGIC, n, r, t};
+    out.write((const char*)header, sizeof(header));
+    for(uint64_t i=0; i<r; ++i)
+    {
+        out.write((const char*)h.row(i), sizeof(uint64_t)*h.get_words());
+    }
+    out.write((const char*)table, (uint64_t(1) << r)*t*sizeof(uint16_t));
+    return bool(out);
+}
+
+bool SyndromeTable::is_valid() const
+{
+    return table != nullptr;
+}
+
+uint64_t SyndromeTable::syndrome(const uint64_t* word) const
+{
+    /* Syndrome bit i is the parity of the popcount of (row i of H) & word. */
+    uint64_t words = h.get_words();
+    uint64_t s = 0;
+    for(uint64_t i=0; i<r; ++i)
+    {
+        const uint64_t* row = h.row(i);
+        uint64_t acc = 0;
+        for(uint64_t j=0; j<words; ++j)
+        {
+            acc ^= row[j] & word[j];
+        }
+        s |= uint64_t(__builtin_popcountll(acc) & 1) << i;
+    }
+    return s;
+}
+
+int SyndromeTable::decode(uint64_t* word) const
+{
+    /*
+     * Correcting a packed word in place. Returns the number of flipped
+     * positions or -1 if the syndrome has no coset leader of weight <= t.
+     * Positions are range checked first, a mapped file can hold anything.
+     */
+    if(table == nullptr)
+    {
+        return -1;
+    }
+    const uint16_t* entry = table + syndrome(word)*t;
+    if(entry[0] == UNKNOWN)
+    {
+        return -1;
+    }
+    int count = 0;
+    while(uint64_t(count) < t && entry[count] != EMPTY)
+    {
+        if(entry[count] >= n)
+        {
+            return -1;
+        }
+        ++count;
+    }
+    for(int i=0; i<count; ++i)
+    {
+        word[entry[i] >> 6] ^= uint64_t(1) << (entry[i] & 63);
+    }
+    return count;
+}
@@ -0,0 +1,188 @@
+#include <iostream>
+#include <atomic>
+#include <cstring>
+#include "WeightDistribution.h"
+#include "Parallel.h"
+
+// Steps between checks of the stop flag
+static const uint64_t STOP_CHECK = uint64_t(1) << 12;
+
+std::vector<uint64_t> weight_distribution(const BitMatrix& g, unsigned threads, uint64_t stop_below)
+{
+    /*
+     * Weight distribution of the code spanned by the rows of g (rows must be
+     * independent): ans[w] is the number of codewords of weight w. All 2^k
+     * codewords are visited in Gray code order, one row XOR per codeword.
+     * The top message bits form a prefix that splits the work into chunks
+     * handed out to threads. If stop_below is not zero, the enumeration stops
+     * once a non-zero codeword lighter than stop_below is found, and the
+     * returned distribution is partial.
+     */
+    uint64_t n = g.get_cols();
+    uint64_t k = g.get_rows();
+    uint64_t words = g.get_words();
+    if(k > 63)
+    {
+        std::cerr<<"Can't enumerate 2^"<<k<<" codewords"<<std::endl;
+        return std::vector<uint64_t>();
+    }
+    if(threads == 0)
+    {
+        threads = default_threads();
+    }
+    uint64_t prefix = 0;
+    while(prefix < k && prefix < 16 && (uint64_t(1) << prefix) < uint64_t(threads)*64)
+    {
+        ++prefix;
+    }
+    uint64_t low = k - prefix;
+    uint64_t chunks = uint64_t(1) << prefix;
+    std::atomic<uint64_t> next(0);
+    std::atomic<bool> stop(false);
+    std::vector<std::vector<uint64_t> > hist(threads, std::vector<uint64_t>(n+1, 0));
+    parallel_for(threads, threads, [&](unsigned lane, uint64_t, uint64_t) {
+        std::vector<uint64_t> cw(words);
+        std::vector<uint64_t>& h = hist[lane];
+        for(uint64_t chunk=next++; chunk<chunks && !stop; chunk=next++)
+        {
+            memset(cw.data(), 0, sizeof(uint64_t)*words);
+            for(uint64_t b=0; b<prefix; ++b)
+            {
+                if((chunk >> b) & 1)
+                {
+                    const uint64_t* row = g.row(low + b);
+                    for(uint64_t j=0; j<words; ++j)
+                    {
+                        cw[j] ^= row[j];
+                    }
+                }
+            }
+            for(uint64_t i=0; i < (uint64_t(1) << low); ++i)
+            {
+                if(i != 0)
+                {
+                    const uint64_t* row = g.row(__builtin_ctzll(i));
+                    for(uint64_t j=0; j<words; ++j)
+                    {
+                        cw[j] ^= row[j];
+                    }
+                }
+                uint64_t w = 0;
+                for(uint64_t j=0; j<words; ++j)
+                {
+                    w += __builtin_popcountll(cw[j]);
+                }
+                ++h[w];
+                if(stop_below != 0)
+                {
+                    if(w != 0 && w < stop_below)
+                    {
+                        stop = true;
+                    }
+                    if((i & (STOP_CHECK - 1)) == 0 && stop)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+    });
+    std::vector<uint64_t> ans(n+1, 0);
+    for(unsigned i=0; i<threads; ++i)
+    {
+        for(uint64_t w=0; w<=n; ++w)
+        {
+            ans[w] += hist[i][w];
+        }
+    }
+    return ans;
+}
+
+uint64_t minimum_distance(const BitMatrix& g, unsigned threads, uint64_t target)
+{
+    /*
+     * Minimal weight of a non-zero codeword. With a non-zero target the search
+     * stops at the first codeword lighter than target, so the answer is exact
+     * if it is >= target and only an upper bound otherwise.
+     */
+    std::vector<uint64_t> dist = weight_distribution(g, threads, target);
+    for(uint64_t w=1; w<dist.size(); ++w)
+    {
+        if(dist[w] != 0)
+        {
+            return w;
+        }
+    }
+    return 0;
+}
+
+std::vector<BigInt> macwilliams(const std::vector<uint64_t>& dual, uint64_t dual_dim)
+{
+    /*
+     * Weight distribution of a code from the distribution of its dual of
+     * dimension dual_dim: A_w = 2^-dual_dim * sum_i B_i K_w(i), where K_w is
+     * the Krawtchouk polynomial computed exactly by the three-term recurrence
+     * (w+1) K_{w+1}(i) = (n-2i) K_w(i) - (n-w+1) K_{w-1}(i).
+     */
+    uint64_t n = dual.size() - 1;
+    std::vector<BigInt> ans(n+1);
+    for(uint64_t i=0; i<=n; ++i)
+    {
+        if(dual[i] == 0)
+        {
+            continue;
+        }
+        int64_t b = int64_t(dual[i]);
+        int64_t slope = int64_t(n) - 2*int64_t(i);
+        BigInt prev(1);
+        BigInt cur(slope);
+        BigInt term(prev);
+        term *= b;
+        ans[0] += term;
+        if(n == 0)
+        {
+            continue;
+        }
+        term = cur;
+        term *= b;
+        ans[1] += term;
+        for(uint64_t w=1; w<n; ++w)
+        {
+            BigInt next(cur);
+            next *= slope;
+            BigInt tail(prev);
+            tail *= int64_t(n - w + 1);
+            next -= tail;
+            next.div_small(uint32_t(w + 1));
+            term = next;
+            term *= b;
+            ans[w+1] += term;
+            prev = cur;
+            cur = next;
+        }
+    }
+    for(uint64_t w=0; w<=n; ++w)
+    {
+        ans[w] >>= dual_dim;
+    }
+    return ans;
+}
+
+std::vector<BigInt> weight_spectrum(const BitMatrix& g, const BitMatrix& h, unsigned threads)
+{
+    /*
+     * Weight distribution of the code with generator g and check matrix h,
+     * enumerating whichever of the code and its dual has fewer codewords.
+     */
+    if(g.get_rows() <= h.get_rows())
+    {
+        std::vector<uint64_t> dist = weight_distribution(g, threads);
+        std::vector<BigInt> ans;
+        for(uint64_t w=0; w<dist.size(); ++w)
+        {
+            ans.push_back(BigInt::from_unsigned(dist[w]));
+        }
+        return ans;
+    }
+    return macwilliams(weight_distribution(h, threads), h.get_rows());
+}
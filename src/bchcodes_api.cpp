@@ -0,0 +1,231 @@
+#include <cstring>
+#include <vector>
+#include "bchcodes_api.h"
+#include "BCHCodes.h"
+#include "BCHDecoder.h"
+
+struct bch_code {
+    int layout; // One of BCH_LAYOUT_*
+    uint64_t len; // Length of a codeword
+    uint64_t t; // Number of correctable errors
+    BitMatrix g; // Generator matrix
+    BitMatrix h; // Check matrix
+    std::vector<uint64_t> gen; // Generator polynomial, packed
+    BCHDecoder* dec; // Decoder of the cyclic or bit order layout
+    uint8_t* bits; // Unpacked word for the decoder
+};
+
+static int split_layout(int layout, bool& verify, unsigned& threads)
+{
+    /* Layout without the flags OR'd into it. */
+    verify = (layout & BCH_NO_VERIFY) == 0;
+    threads = unsigned(layout >> 16) & 0x7FFF;
+    return layout & 0xFF;
+}
+
+bch_code* bch_code_create(uint64_t n, uint64_t d, int layout)
+{
+    bool verify;
+    unsigned threads;
+    layout = split_layout(layout, verify, threads);
+    if(n < 3 || n > (uint64_t(1) << 20) - 1 || __builtin_popcountll(n+1) != 1 || d < 2 || d > n)
+    {
+        return nullptr;
+    }
+    if(layout != BCH_LAYOUT_BIT_ORDER && layout != BCH_LAYOUT_SYSTEMATIC && layout != BCH_LAYOUT_SYSTEMATIC_EXTENDED)
+    {
+        return nullptr;
+    }
+    bch_code* code = nullptr;
+    try
+    {
+        code = new bch_code();
+        code->layout = layout;
+        code->dec = nullptr;
+        code->bits = nullptr;
+        bool built = layout == BCH_LAYOUT_BIT_ORDER ?
+                     bch_matrices_bit_order(n, d, code->g, code->h, threads, verify) :
+                     bch_matrices_systematic(n, d, layout == BCH_LAYOUT_SYSTEMATIC_EXTENDED, code->g, code->h, verify,
+                                             threads);
+        if(!built)
+        {
+            bch_code_destroy(code);
+            return nullptr;
+        }
+        code->len = code->g.get_cols();
+        code->gen = bch_generator_poly(n, d);
+        code->dec = new BCHDecoder(n, d, layout == BCH_LAYOUT_BIT_ORDER);
+        code->t = code->dec->get_t();
+        code->bits = new uint8_t[code->len];
+    }
+    catch(...)
+    {
+        // Nothing may unwind into a C caller: allocation, thread creation, anything else
+        bch_code_destroy(code);
+        return nullptr;
+    }
+    return code;
+}
+
+int64_t bch_code_sweep(uint64_t n, int layout, bch_sweep_callback fn, void* context)
+{
+    bool verify;
+    unsigned threads;
+    layout = split_layout(layout, verify, threads);
+    if(n < 3 || n > (uint64_t(1) << 20) - 1 || __builtin_popcountll(n+1) != 1)
+    {
+        return -1;
+    }
+    if(layout != BCH_LAYOUT_SYSTEMATIC && layout != BCH_LAYOUT_SYSTEMATIC_EXTENDED)
+    {
+        return -1;
+    }
+    int64_t count = 0;
+    bch_code code;
+    code.layout = layout;
+    code.len = layout == BCH_LAYOUT_SYSTEMATIC_EXTENDED ? n + 1 : n;
+    code.dec = nullptr;
+    code.bits = nullptr;
+    try
+    {
+        code.bits = new uint8_t[code.len];
+        bool verified = bch_sweep_systematic(n, layout == BCH_LAYOUT_SYSTEMATIC_EXTENDED, code.gen, code.g, code.h,
+                                             [&](uint64_t d) {
+            // One decoder for the whole sweep, the field tables are built once
+            if(code.dec == nullptr)
+            {
+                code.dec = new BCHDecoder(n, d, false);
+            }
+            else
+            {
+                code.dec->set_distance(d);
+            }
+            code.t = code.dec->get_t();
+            fn(&code, d, context);
+            ++count;
+        }, verify, threads);
+        count = verified ? count : -1;
+    }
+    catch(...)
+    {
+        count = -1;
+    }
+    delete code.dec;
+    delete[] code.bits;
+    return count;
+}
+
+void bch_code_destroy(bch_code* code)
+{
+    if(code == nullptr)
+    {
+        return;
+    }
+    delete code->dec;
+    delete[] code->bits;
+    delete code;
+}
+
+uint64_t bch_code_length(const bch_code* code)
+{
+    return code->len;
+}
+
+uint64_t bch_code_dimension(const bch_code* code)
+{
+    return code->g.get_rows();
+}
+
+uint64_t bch_code_check_rows(const bch_code* code)
+{
+    return code->h.get_rows();
+}
+
+uint64_t bch_code_words(const bch_code* code)
+{
+    return code->g.get_words();
+}
+
+uint64_t bch_code_poly_words(const bch_code* code)
+{
+    return code->gen.size();
+}
+
+void bch_code_get_generator(const bch_code* code, uint64_t* g)
+{
+    uint64_t words = code->g.get_words();
+    for(uint64_t i=0; i<code->g.get_rows(); ++i)
+    {
+        memcpy(g + i*words, code->g.row(i), sizeof(uint64_t)*words);
+    }
+}
+
+void bch_code_get_check(const bch_code* code, uint64_t* h)
+{
+    uint64_t words = code->h.get_words();
+    for(uint64_t i=0; i<code->h.get_rows(); ++i)
+    {
+        memcpy(h + i*words, code->h.row(i), sizeof(uint64_t)*words);
+    }
+}
+
+uint64_t bch_code_get_generator_poly(const bch_code* code, uint64_t* poly)
+{
+    memcpy(poly, code->gen.data(), sizeof(uint64_t)*code->gen.size());
+    return deg_poly(code->gen);
+}
+
+void bch_code_encode(const bch_code* code, const uint64_t* message, uint64_t* codeword)
+{
+    /* Sum of the rows of G picked by the message bits. */
+    uint64_t words = code->g.get_words();
+    memset(codeword, 0, sizeof(uint64_t)*words);
+    for(uint64_t i=0; i<code->g.get_rows(); ++i)
+    {
+        if((message[i >> 6] >> (i & 63)) & 1)
+        {
+            const uint64_t* row = code->g.row(i);
+            for(uint64_t w=0; w<words; ++w)
+            {
+                codeword[w] ^= row[w];
+            }
+        }
+    }
+}
+
+int bch_code_decode(bch_code* code, uint64_t* word)
+{
+    /*
+     * The systematic extended layout decodes the cyclic part and then settles the
+     * parity column the same way the bit order decoder settles its column 0.
+     */
+    uint8_t parity = 0;
+    for(uint64_t p=0; p<code->len; ++p)
+    {
+        code->bits[p] = uint8_t((word[p >> 6] >> (p & 63)) & 1);
+        parity ^= code->bits[p];
+    }
+    int count = code->dec->decode(code->bits);
+    if(count < 0)
+    {
+        return -1;
+    }
+    if(code->layout == BCH_LAYOUT_SYSTEMATIC_EXTENDED && (parity ^ (count & 1)) != 0)
+    {
+        if(uint64_t(count) == code->t)
+        {
+            return -1;
+        }
+        code->bits[code->len-1] ^= 1;
+        ++count;
+    }
+    for(uint64_t w=0; w<code->g.get_words(); ++w)
+    {
+        word[w] = 0;
+    }
+    for(uint64_t p=0; p<code->len; ++p)
+    {
+        word[p >> 6] |= uint64_t(code->bits[p]) << (p & 63);
+    }
+    return count;
+}
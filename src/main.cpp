@@ -1,37 +1,238 @@
 #include <iostream>
+#include "bchcodes_api.h"
 #include "BCHCodes.h"
+#include "BitMatrix.h"
+#include "AsyncWriter.h"
+#include "WeightDistribution.h"
 #include <fstream>
+#include <string>
+#include <vector>
 
 void usage()
 {
-    std::cout<<"Usage: bch_matrices n d filename\nn - length of the code;\nd - minimal distance of the code;\nfilename - optional, if given - outputs matrices in the file, else - outputs in console"<<std::endl;
+    std::cout<<"Usage: bch_matrices [options] n d filename\n       bch_matrices --sweep [options] n filename\nn - length of the code;\nd - minimal distance of the code;\nfilename - optional, if given - outputs matrices in the file, else - outputs in console\n"
+               "Options:\n--weights - output the weight distribution and the minimal distance instead of matrices;\n"
+               "--systematic - systematic matrices of the cyclic code built from its generator polynomial;\n"
+               "--extended - with --systematic, add the overall parity column;\n"
+               "--cyclic - non-systematic matrices of the cyclic code, rows are shifts of g(x) and of the reversed h(x);\n"
+               "--sweep - every code of length n in systematic form, d is not given;\n"
+               "--no-verify - skip the check of the matrices after building them;\n"
+               "--direct - write the output file with O_DIRECT;\n"
+               "--threads T - number of threads, all cores by default.\n"
+               "A single code is written once its matrices are built; with --sweep the next code and with --cyclic\n"
+               "the next rows are built while earlier ones are written on a separate thread"<<std::endl;
+}
+
+static void load_matrix(const std::vector<uint64_t>& packed, uint64_t rows, uint64_t cols, BitMatrix& a)
+{
+    a.resize(rows, cols);
+    for(uint64_t i=0; i<rows; ++i)
+    {
+        for(uint64_t w=0; w<a.get_words(); ++w)
+        {
+            a.row(i)[w] = packed[i*a.get_words() + w];
+        }
+    }
+}
+
+static void print_matrices(const bch_code* code, const char* name, AsyncWriter& writer)
+{
+    /* Rows go to the writer thread, the caller can go on with the next code meanwhile. */
+    uint64_t n = bch_code_length(code);
+    uint64_t k = bch_code_dimension(code);
+    uint64_t r = bch_code_check_rows(code);
+    std::vector<uint64_t> g(k*bch_code_words(code)), h(r*bch_code_words(code));
+    bch_code_get_generator(code, g.data());
+    bch_code_get_check(code, h.data());
+    writer.text(std::string(name) + "(" + std::to_string(n) + ", " + std::to_string(k) + ")\n\n" +
+                std::to_string(n) + " " + std::to_string(k) + "\n\n");
+    writer.rows(g.data(), k, n);
+    writer.text("\n");
+    writer.rows(h.data(), r, n);
+}
+
+static void print_weights(const bch_code* code, const char* name, unsigned threads, std::ostream& output)
+{
+    uint64_t n = bch_code_length(code);
+    uint64_t k = bch_code_dimension(code);
+    uint64_t r = bch_code_check_rows(code);
+    std::vector<uint64_t> packed_g(k*bch_code_words(code)), packed_h(r*bch_code_words(code));
+    bch_code_get_generator(code, packed_g.data());
+    bch_code_get_check(code, packed_h.data());
+    BitMatrix g, h;
+    load_matrix(packed_g, k, n, g);
+    load_matrix(packed_h, r, n, h);
+    std::vector<BigInt> dist = weight_spectrum(g, h, threads);
+    uint64_t dmin = 0;
+    for(uint64_t w=1; w<dist.size() && dmin == 0; ++w)
+    {
+        if(!dist[w].is_zero())
+        {
+            dmin = w;
+        }
+    }
+    output<<name<<"("<<n<<", "<<k<<")\n\n";
+    output<<"d = "<<dmin<<"\n\n";
+    for(uint64_t w=0; w<dist.size(); ++w)
+    {
+        if(!dist[w].is_zero())
+        {
+            output<<w<<" "<<dist[w].to_string()<<"\n";
+        }
+    }
+}
+
+struct SweepOutput {
+    std::ostream* output; // Weights are printed here
+    AsyncWriter* writer; // Matrices are printed here
+    const char* name;
+    unsigned threads;
+};
+
+static void print_sweep(bch_code* code, uint64_t d, void* context)
+{
+    SweepOutput* out = static_cast<SweepOutput*>(context);
+    if(out->writer == nullptr)
+    {
+        *out->output<<"d = "<<d<<"\n\n";
+        print_weights(code, out->name, out->threads, *out->output);
+        *out->output<<"\n";
+    }
+    else
+    {
+        out->writer->text("d = " + std::to_string(d) + "\n\n");
+        print_matrices(code, out->name, *out->writer);
+        out->writer->text("\n");
+    }
 }
 
 int main(int argc,  char** argv) {
-    if(!(argc == 3 || argc == 4))
+    bool weights = false;
+    bool systematic = false;
+    bool extended = false;
+    bool sweep = false;
+    bool direct = false;
+    bool cyclic = false;
+    bool verify = true;
+    unsigned threads = 0;
+    std::vector<char*> args;
+    for(int i=1; i<argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--weights")
+        {
+            weights = true;
+        }
+        else if(arg == "--systematic")
+        {
+            systematic = true;
+        }
+        else if(arg == "--sweep")
+        {
+            sweep = true;
+        }
+        else if(arg == "--extended")
+        {
+            extended = true;
+        }
+        else if(arg == "--cyclic")
+        {
+            cyclic = true;
+        }
+        else if(arg == "--no-verify")
+        {
+            verify = false;
+        }
+        else if(arg == "--direct")
+        {
+            direct = true;
+        }
+        else if(arg == "--threads" && i+1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else
+        {
+            args.push_back(argv[i]);
+        }
+    }
+    uint64_t positional = sweep ? 1 : 2;
+    if(!(args.size() == positional || args.size() == positional + 1))
     {
         usage();
+        return 0;
+    }
+    unsigned n = atoi(args[0]);
+    unsigned d = sweep ? 0 : atoi(args[1]);
+    const char* path = args.size() == positional + 1 ? args[positional] : nullptr;
+    // Weights are short and go through a stream, matrices through the writer; only a
+    // sweep builds the next code while the last one is written, so only a sweep gets
+    // the writer thread. Cyclic matrices are streamed from their polynomials and run
+    // their own writer
+    bool stream = weights || (cyclic && !sweep);
+    std::ofstream fout;
+    AsyncWriter* writer = nullptr;
+    if(stream && path != nullptr)
+    {
+        fout.open(path);
+    }
+    else if(!stream)
+    {
+        writer = path != nullptr ? new AsyncWriter(path, direct, sweep) : new AsyncWriter(std::cout, sweep);
+    }
+    std::ostream output(path != nullptr ? fout.rdbuf() : std::cout.rdbuf());
+    int layout = !systematic && !sweep ? BCH_LAYOUT_BIT_ORDER :
+                 extended ? BCH_LAYOUT_SYSTEMATIC_EXTENDED : BCH_LAYOUT_SYSTEMATIC;
+    const char* name = layout == BCH_LAYOUT_SYSTEMATIC ? "BCH" : "EBCH";
+    int flags = (verify ? 0 : BCH_NO_VERIFY) | BCH_THREADS(threads);
+    if(sweep)
+    {
+        SweepOutput out;
+        out.output = &output;
+        out.writer = writer;
+        out.name = name;
+        out.threads = threads;
+        if(bch_code_sweep(n, layout | flags, print_sweep, &out) < 0)
+        {
+            std::cerr<<"Can't build BCH codes of length "<<n<<std::endl;
+        }
+    }
+    else if(cyclic && !weights)
+    {
+        if(n < 3 || __builtin_popcount(n+1) != 1 || d < 2 || d > n)
+        {
+            std::cerr<<"Can't build a BCH code with n = "<<n<<", d = "<<d<<std::endl;
+        }
+        else
+        {
+            // Not through the C API: its codes hold materialized G and H, these matrices are
+            // streamed from the two polynomials in O(n) memory, on the writer thread; nothing
+            // here is split between threads, so --threads does not apply
+            build_bch_matrices(n, d, output);
+        }
     }
     else
     {
-        unsigned n, d;
-        n = atoi(argv[1]);
-        d = atoi(argv[2]);
-        std::streambuf* buf;
-        std::ofstream fout;
-        if(argc == 3)
+        bch_code* code = bch_code_create(n, d, layout | flags);
+        if(code == nullptr)
+        {
+            std::cerr<<"Can't build a BCH code with n = "<<n<<", d = "<<d<<std::endl;
+        }
+        else if(weights)
         {
-            buf = std::cout.rdbuf();
+            print_weights(code, name, threads, output);
         }
         else
         {
-            fout.open(argv[3]);
-            buf = fout.rdbuf();
+            print_matrices(code, name, *writer);
         }
-        std::ostream output(buf);
-        // build_bch_matrices(n, d, output);
-        build_bch_matrices_bit_order(n, d, output);
-        fout.close();
+        bch_code_destroy(code);
+    }
+    if(writer != nullptr && !writer->finish())
+    {
+        std::cerr<<"Output is incomplete"<<std::endl;
     }
+    delete writer;
+    fout.close();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cstring>
+#include "tests.h"
+
+std::mt19937_64 rng(20240601);
+
+bool check(bool ok, const std::string& what)
+{
+    if(!ok)
+    {
+        std::cerr<<"FAILED: "<<what<<std::endl;
+    }
+    return ok;
+}
+
+void random_codeword(const BitMatrix& g, uint64_t* word)
+{
+    /* Sum of a random subset of the rows of g. */
+    memset(word, 0, sizeof(uint64_t)*g.get_words());
+    for(uint64_t i=0; i<g.get_rows(); ++i)
+    {
+        if(rng() & 1)
+        {
+            for(uint64_t w=0; w<g.get_words(); ++w)
+            {
+                word[w] ^= g.row(i)[w];
+            }
+        }
+    }
+}
+
+std::vector<uint64_t> random_positions(uint64_t n, uint64_t count)
+{
+    /* count distinct positions below n. */
+    std::vector<uint64_t> ans;
+    while(ans.size() < count)
+    {
+        uint64_t p = rng() % n;
+        bool seen = false;
+        for(uint64_t i=0; i<ans.size(); ++i)
+        {
+            seen = seen || ans[i] == p;
+        }
+        if(!seen)
+        {
+            ans.push_back(p);
+        }
+    }
+    return ans;
+}
+
+void to_llr(const uint64_t* word, uint64_t n, const std::vector<uint64_t>& errors, float* llr)
+{
+    /* Reliable LLRs of word, the error positions get weak LLRs of the wrong sign. */
+    for(uint64_t p=0; p<n; ++p)
+    {
+        llr[p] = ((word[p >> 6] >> (p & 63)) & 1) ? -4.0f : 4.0f;
+    }
+    for(uint64_t i=0; i<errors.size(); ++i)
+    {
+        llr[errors[i]] = -0.5f * llr[errors[i]] / 4.0f;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    struct Test {
+        const char* name;
+        bool (*run)();
+    };
+    Test tests[] = {{"rm", test_rm}, {"rm_invalid", test_rm_invalid},
+                    {"rs", test_rs}, {"rs_invalid", test_rs_invalid},
+                    {"bch", test_bch}, {"chase", test_chase},
+                    {"osd", test_osd},
+                    {"syndrome_table", test_syndrome_table}, {"syndrome_table_invalid", test_syndrome_table_invalid},
+                    {"weights", test_weights}, {"macwilliams", test_macwilliams},
+                    {"gf", test_gf}, {"fft", test_fft},
+                    {"bit_order", test_bit_order}, {"systematic", test_systematic},
+                    {"api", test_api},
+                    {"sweep", test_sweep}, {"set_distance", test_set_distance},
+                    {"writer", test_writer}, {"writer_failure", test_writer_failure},
+                    {"bp", test_bp}, {"cyclic", test_cyclic},
+                    {"matrix", test_matrix}};
+    bool ok = true;
+    bool found = false;
+    for(uint64_t i=0; i<sizeof(tests)/sizeof(tests[0]); ++i)
+    {
+        if(argc < 2 || std::string(argv[1]) == tests[i].name)
+        {
+            found = true;
+            ok = tests[i].run() && ok;
+        }
+    }
+    if(!found)
+    {
+        std::cerr<<"Unknown test "<<argv[1]<<std::endl;
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
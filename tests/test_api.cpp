@@ -0,0 +1,68 @@
+#include <algorithm>
+#include "tests.h"
+#include "bchcodes_api.h"
+
+static std::vector<uint64_t> matrices(const bch_code* code)
+{
+    /* G and H one after another. */
+    uint64_t words = bch_code_words(code);
+    std::vector<uint64_t> ans((bch_code_dimension(code) + bch_code_check_rows(code))*words);
+    bch_code_get_generator(code, ans.data());
+    bch_code_get_check(code, ans.data() + bch_code_dimension(code)*words);
+    return ans;
+}
+
+bool test_api()
+{
+    /* Encode, add up to t errors and decode through the C API for every layout. */
+    bool ok = true;
+    int layouts[] = {BCH_LAYOUT_BIT_ORDER, BCH_LAYOUT_SYSTEMATIC, BCH_LAYOUT_SYSTEMATIC_EXTENDED};
+    for(int l=0; l<3; ++l)
+    {
+        std::string name = "C API, layout " + std::to_string(layouts[l]);
+        bch_code* code = bch_code_create(255, 15, layouts[l]);
+        ok &= check(code != nullptr, name + " is created");
+        if(code == nullptr)
+        {
+            continue;
+        }
+        uint64_t n = bch_code_length(code), k = bch_code_dimension(code), words = bch_code_words(code);
+        ok &= check(n == (layouts[l] == BCH_LAYOUT_SYSTEMATIC ? 255u : 256u) && k == 199, name + " parameters");
+        std::vector<uint64_t> poly(bch_code_poly_words(code));
+        ok &= check(bch_code_get_generator_poly(code, poly.data()) == 255 - k, name + " generator degree");
+        std::vector<uint64_t> msg((k + 63) / 64), cw(words), word(words);
+        for(int trial=0; trial<30; ++trial)
+        {
+            std::fill(msg.begin(), msg.end(), 0);
+            for(uint64_t i=0; i<k; ++i)
+            {
+                msg[i >> 6] |= (rng() & 1) << (i & 63);
+            }
+            bch_code_encode(code, msg.data(), cw.data());
+            word = cw;
+            std::vector<uint64_t> errors = random_positions(n, rng() % 8);
+            for(uint64_t i=0; i<errors.size(); ++i)
+            {
+                word[errors[i] >> 6] ^= uint64_t(1) << (errors[i] & 63);
+            }
+            ok &= check(bch_code_decode(code, word.data()) == int(errors.size()) && word == cw, name + " round trip");
+        }
+        // The flags change neither matrix
+        bch_code* one = bch_code_create(255, 15, layouts[l] | BCH_THREADS(1));
+        bch_code* fast = bch_code_create(255, 15, layouts[l] | BCH_THREADS(4) | BCH_NO_VERIFY);
+        ok &= check(one != nullptr && fast != nullptr, name + " with flags is created");
+        if(one != nullptr && fast != nullptr)
+        {
+            ok &= check(matrices(one) == matrices(code) && matrices(fast) == matrices(code), name + " with flags");
+        }
+        bch_code_destroy(one);
+        bch_code_destroy(fast);
+        bch_code_destroy(code);
+    }
+    // Invalid arguments give NULL
+    ok &= check(bch_code_create(254, 5, BCH_LAYOUT_BIT_ORDER) == nullptr, "length is not 2^m - 1");
+    ok &= check(bch_code_create(255, 1, BCH_LAYOUT_BIT_ORDER) == nullptr, "distance below 2");
+    ok &= check(bch_code_create(255, 256, BCH_LAYOUT_BIT_ORDER) == nullptr, "distance above n");
+    ok &= check(bch_code_create(255, 5, 7) == nullptr, "unknown layout");
+    return ok;
+}
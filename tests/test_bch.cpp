@@ -0,0 +1,106 @@
+#include "tests.h"
+#include "BCHCodes.h"
+#include "BCHDecoder.h"
+#include "GF.h"
+
+static bool bch_round_trip(BCHDecoder& dec, const BitMatrix& g, const std::string& name)
+{
+    /* Up to t errors on random codewords of g are corrected and counted. */
+    bool ok = true;
+    uint64_t n = g.get_cols();
+    std::vector<uint64_t> cw(g.get_words());
+    std::vector<uint8_t> word(n);
+    for(int trial=0; trial<50; ++trial)
+    {
+        random_codeword(g, cw.data());
+        std::vector<uint64_t> errors = random_positions(n, rng() % (dec.get_t() + 1));
+        for(uint64_t p=0; p<n; ++p)
+        {
+            word[p] = uint8_t((cw[p >> 6] >> (p & 63)) & 1);
+        }
+        for(uint64_t i=0; i<errors.size(); ++i)
+        {
+            word[errors[i]] ^= 1;
+        }
+        int count = dec.decode(word.data());
+        bool same = true;
+        for(uint64_t p=0; p<n; ++p)
+        {
+            same = same && word[p] == ((cw[p >> 6] >> (p & 63)) & 1);
+        }
+        ok &= check(uint64_t(count) == errors.size() && same, name);
+    }
+    return ok;
+}
+
+static void cyclic_generator(uint64_t n, uint64_t d, BitMatrix& g)
+{
+    /* Rows x^i g(x), the cyclic layout of the decoder. */
+    std::vector<uint64_t> gen = bch_generator_poly(n, d);
+    uint64_t r = deg_poly(gen);
+    g.resize(n - r, n);
+    for(uint64_t i=0; i<n-r; ++i)
+    {
+        for(uint64_t j=0; j<=r; ++j)
+        {
+            g.set(i, i + j, int((gen[j >> 6] >> (j & 63)) & 1));
+        }
+    }
+}
+
+bool test_bch()
+{
+    /* Both layouts, small and large t, including t large enough for the FFT Chien search. */
+    bool ok = true;
+    uint64_t codes[][2] = {{15, 5}, {63, 11}, {255, 21}, {1023, 41}, {1023, 301}};
+    for(uint64_t c=0; c<sizeof(codes)/sizeof(codes[0]); ++c)
+    {
+        uint64_t n = codes[c][0], d = codes[c][1];
+        std::string name = "BCH(" + std::to_string(n) + ", d = " + std::to_string(d) + ")";
+        BitMatrix g, eg, eh;
+        cyclic_generator(n, d, g);
+        BCHDecoder cyclic(n, d);
+        ok &= bch_round_trip(cyclic, g, name + " cyclic");
+        ok &= check(bch_matrices_bit_order(n, d, eg, eh), name + " bit order matrices");
+        BCHDecoder bit_order(n, d, true);
+        ok &= bch_round_trip(bit_order, eg, name + " bit order");
+    }
+    return ok;
+}
+
+bool test_chase()
+{
+    /*
+     * t errors plus two more on the least reliable positions are still corrected,
+     * on the calling thread and with the test patterns split between threads.
+     */
+    bool ok = true;
+    uint64_t n = 255, d = 11;
+    BitMatrix g, h;
+    bch_matrices_bit_order(n, d, g, h);
+    BCHDecoder dec(n, d, true);
+    uint64_t setups[][2] = {{4, 1}, {4, 2}, {10, 1}, {10, 4}};
+    for(uint64_t c=0; c<4; ++c)
+    {
+        ChaseDecoder chase(dec, setups[c][0], unsigned(setups[c][1]));
+        std::string name = "Chase with " + std::to_string(setups[c][0]) + " flips, " +
+                           std::to_string(setups[c][1]) + " threads";
+        std::vector<uint64_t> cw(g.get_words());
+        std::vector<float> llr(g.get_cols());
+        std::vector<uint8_t> word(g.get_cols());
+        for(int trial=0; trial<(setups[c][0] > 4 ? 5 : 30); ++trial)
+        {
+            random_codeword(g, cw.data());
+            std::vector<uint64_t> errors = random_positions(g.get_cols(), dec.get_t() + 2);
+            to_llr(cw.data(), g.get_cols(), errors, llr.data());
+            ok &= check(chase.decode(llr.data(), word.data()) >= 0, name + " decodes");
+            bool same = true;
+            for(uint64_t p=0; p<g.get_cols(); ++p)
+            {
+                same = same && word[p] == ((cw[p >> 6] >> (p & 63)) & 1);
+            }
+            ok &= check(same, name + " codeword");
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,96 @@
+#include <cstring>
+#include "tests.h"
+#include "BCHCodes.h"
+#include "GaussianElimination.h"
+#include "GF.h"
+
+static bool in_code(const uint64_t* word, uint64_t n, const std::vector<uint64_t>& powers, uint64_t d)
+{
+    /* Definition of the extended code: even weight and sum of x^j over the ones is 0 for j < d. */
+    uint64_t parity = 0;
+    std::vector<uint64_t> sums(d, 0);
+    for(uint64_t x=0; x<=n; ++x)
+    {
+        if((word[x >> 6] >> (x & 63)) & 1)
+        {
+            parity ^= 1;
+            for(uint64_t j=1; j<d; ++j)
+            {
+                sums[j] ^= powers[x*d + j];
+            }
+        }
+    }
+    bool ok = parity == 0;
+    for(uint64_t j=1; j<d; ++j)
+    {
+        ok = ok && sums[j] == 0;
+    }
+    return ok;
+}
+
+bool test_bit_order()
+{
+    /*
+     * Matrices of the extended code from n = 255 on, where the uint128 column
+     * packing used to break: every row of G satisfies the definition of the code,
+     * G has the dimension given by the generator polynomial, H has full rank and
+     * G H^T = 0 by plain dot products. One and four threads give the same matrices.
+     */
+    bool ok = true;
+    uint64_t codes[][2] = {{255, 9}, {255, 37}, {511, 21}, {1023, 41}, {2047, 11}};
+    for(uint64_t c=0; c<sizeof(codes)/sizeof(codes[0]); ++c)
+    {
+        uint64_t n = codes[c][0], d = codes[c][1];
+        std::string name = "EBCH(" + std::to_string(n + 1) + ", d = " + std::to_string(d) + ")";
+        BitMatrix g, h, g4, h4;
+        ok &= check(bch_matrices_bit_order(n, d, g, h, 1), name + " is built");
+        bch_matrices_bit_order(n, d, g4, h4, 4);
+        uint64_t k = n - deg_poly(bch_generator_poly(n, d));
+        ok &= check(g.get_rows() == k && h.get_rows() == n + 1 - k && g.get_cols() == n + 1, name + " dimensions");
+        bool same = g4.get_rows() == g.get_rows() && h4.get_rows() == h.get_rows();
+        for(uint64_t i=0; i<g.get_rows() && same; ++i)
+        {
+            same = memcmp(g.row(i), g4.row(i), sizeof(uint64_t)*g.get_words()) == 0;
+        }
+        for(uint64_t i=0; i<h.get_rows() && same; ++i)
+        {
+            same = memcmp(h.row(i), h4.row(i), sizeof(uint64_t)*h.get_words()) == 0;
+        }
+        ok &= check(same, name + " is the same on four threads");
+        GF2 field(__builtin_ctzll(n + 1));
+        std::vector<uint64_t> powers((n + 1)*d, 0);
+        for(uint64_t x=0; x<=n; ++x)
+        {
+            uint64_t p = 1;
+            for(uint64_t j=1; j<d; ++j)
+            {
+                p = field.mul(p, x);
+                powers[x*d + j] = p;
+            }
+        }
+        bool codewords = true;
+        for(uint64_t i=0; i<g.get_rows() && codewords; ++i)
+        {
+            codewords = in_code(g.row(i), n, powers, d);
+        }
+        ok &= check(codewords, name + " rows of G are codewords");
+        BitMatrix eg(g), eh(h);
+        ok &= check(uint64_t(upperEchelonForm(eg)) == k, name + " rank of G");
+        ok &= check(uint64_t(upperEchelonForm(eh)) == n + 1 - k, name + " rank of H");
+        bool orthogonal = true;
+        for(uint64_t i=0; i<g.get_rows() && orthogonal; ++i)
+        {
+            for(uint64_t j=0; j<h.get_rows() && orthogonal; ++j)
+            {
+                uint64_t acc = 0;
+                for(uint64_t w=0; w<g.get_words(); ++w)
+                {
+                    acc ^= g.row(i)[w] & h.row(j)[w];
+                }
+                orthogonal = (__builtin_popcountll(acc) & 1) == 0;
+            }
+        }
+        ok &= check(orthogonal, name + " G H^T = 0");
+    }
+    return ok;
+}
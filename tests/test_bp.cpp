@@ -0,0 +1,47 @@
+#include <cstring>
+#include "tests.h"
+#include "BCHCodes.h"
+#include "BPDecoder.h"
+
+bool test_bp()
+{
+    /*
+     * Weak wrong positions are pulled back by min-sum on frame counts that
+     * are not a multiple of the batch, and by adaptive BP one frame at a time.
+     */
+    bool ok = true;
+    BitMatrix g, h;
+    bch_matrices_bit_order(63, 7, g, h);
+    uint64_t n = g.get_cols(), words = g.get_words();
+    uint64_t frame_counts[] = {1, 16, 41};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        uint64_t frames = frame_counts[c];
+        std::vector<uint64_t> cw(frames*words), out(frames*words);
+        std::vector<uint8_t> valid(frames);
+        std::vector<float> llr(frames*n);
+        for(uint64_t f=0; f<frames; ++f)
+        {
+            random_codeword(g, cw.data() + f*words);
+            to_llr(cw.data() + f*words, n, random_positions(n, f % 2), llr.data() + f*n);
+        }
+        BPDecoder bp(h, 16, 20);
+        ok &= check(bp.decode(llr.data(), frames, out.data(), valid.data()) == frames && out == cw,
+                    "min-sum decoding of " + std::to_string(frames) + " frames");
+        for(uint64_t f=0; f<frames; ++f)
+        {
+            ok &= check(valid[f] != 0, "min-sum frame is valid");
+        }
+    }
+    ABPDecoder abp(h);
+    std::vector<uint64_t> cw(words), out(words);
+    std::vector<float> llr(n);
+    for(int trial=0; trial<40; ++trial)
+    {
+        random_codeword(g, cw.data());
+        to_llr(cw.data(), n, random_positions(n, 3), llr.data());
+        ok &= check(abp.decode(llr.data(), out.data()), "adaptive BP converges");
+        ok &= check(memcmp(out.data(), cw.data(), sizeof(uint64_t)*words) == 0, "adaptive BP codeword");
+    }
+    return ok;
+}
@@ -0,0 +1,152 @@
+#include <cstring>
+#include "tests.h"
+#include "BCHCodes.h"
+#include "CyclicMatrix.h"
+
+static BitMatrix materialize(const CyclicMatrix& a)
+{
+    BitMatrix ans(a.get_rows(), a.get_cols());
+    if(a.get_rows() > 0)
+    {
+        a.row_block(0, a.get_rows(), ans.row(0));
+    }
+    return ans;
+}
+
+static bool same_as_views(const CyclicMatrix& a, const std::string& name)
+{
+    /* Rows against get, columns against the rows, products against plain dot products. */
+    bool ok = true;
+    BitMatrix m = materialize(a);
+    uint64_t rows = a.get_rows(), cols = a.get_cols();
+    uint64_t rwords = (rows + 63) >> 6;
+    for(uint64_t i=0; i<rows && ok; ++i)
+    {
+        for(uint64_t j=0; j<cols && ok; ++j)
+        {
+            ok = m.get(i, j) == a.get(i, j);
+        }
+    }
+    ok = check(ok, name + " rows");
+    std::vector<uint64_t> col(rwords + 1);
+    bool cols_ok = true;
+    for(uint64_t j=0; j<cols && cols_ok; ++j)
+    {
+        col[rwords] = 0x5a5a;
+        a.col(j, col.data());
+        for(uint64_t i=0; i<rows && cols_ok; ++i)
+        {
+            cols_ok = int((col[i >> 6] >> (i & 63)) & 1) == m.get(i, j);
+        }
+        cols_ok = cols_ok && col[rwords] == 0x5a5a && (rows % 64 == 0 || (col[rwords-1] >> (rows % 64)) == 0);
+    }
+    ok &= check(cols_ok, name + " columns");
+    // The same workspace for every product, both directions
+    CyclicWorkspace w;
+    std::vector<uint64_t> x(rwords + 1), y(m.get_words() + 1), s(rwords + 1);
+    bool products = true;
+    for(int trial=0; trial<20 && products; ++trial)
+    {
+        std::fill(x.begin(), x.end(), 0);
+        std::fill(y.begin(), y.end(), 0);
+        for(uint64_t i=0; i<rows; ++i)
+        {
+            x[i >> 6] |= (rng() & 1) << (i & 63);
+        }
+        for(uint64_t j=0; j<cols; ++j)
+        {
+            y[j >> 6] |= (rng() & 1) << (j & 63);
+        }
+        std::vector<uint64_t> yy(m.get_words() + 1, 0);
+        a.mul(x.data(), yy.data(), w);
+        for(uint64_t j=0; j<cols && products; ++j)
+        {
+            int bit = 0;
+            for(uint64_t i=0; i<rows; ++i)
+            {
+                bit ^= int((x[i >> 6] >> (i & 63)) & 1) & m.get(i, j);
+            }
+            products = bit == int((yy[j >> 6] >> (j & 63)) & 1);
+        }
+        std::fill(s.begin(), s.end(), 0);
+        a.mul_transposed(y.data(), s.data(), w);
+        for(uint64_t i=0; i<rows && products; ++i)
+        {
+            uint64_t acc = 0;
+            for(uint64_t l=0; l<m.get_words(); ++l)
+            {
+                acc ^= m.row(i)[l] & y[l];
+            }
+            products = uint64_t(__builtin_popcountll(acc) & 1) == ((s[i >> 6] >> (i & 63)) & 1);
+        }
+        products = products && yy[m.get_words()] == 0 && s[rwords] == 0;
+    }
+    ok &= check(products, name + " products");
+    return ok;
+}
+
+bool test_cyclic()
+{
+    /*
+     * Views against the matrices they describe: rows, columns and both
+     * products, for a few polynomials of different lengths and for the
+     * BCH generator and check views, whose syndromes vanish on codewords.
+     */
+    bool ok = true;
+    uint64_t sizes[][2] = {{3, 7}, {1, 64}, {60, 130}, {70, 129}, {200, 257}};
+    for(uint64_t c=0; c<sizeof(sizes)/sizeof(sizes[0]); ++c)
+    {
+        uint64_t rows = sizes[c][0], cols = sizes[c][1];
+        uint64_t deg = cols - rows;
+        std::vector<uint64_t> poly(deg / 64 + 1, 0);
+        for(uint64_t t=0; t<deg; ++t)
+        {
+            poly[t >> 6] |= (rng() & 1) << (t & 63);
+        }
+        poly[0] |= 1;
+        poly[deg >> 6] |= uint64_t(1) << (deg & 63);
+        ok &= same_as_views(CyclicMatrix(poly, rows, cols),
+                            "Cyclic " + std::to_string(rows) + " x " + std::to_string(cols));
+    }
+    uint64_t codes[][2] = {{15, 5}, {63, 11}, {255, 21}, {1023, 41}, {1023, 301}};
+    for(uint64_t c=0; c<sizeof(codes)/sizeof(codes[0]); ++c)
+    {
+        uint64_t n = codes[c][0], d = codes[c][1];
+        std::string name = "BCH(" + std::to_string(n) + ", d = " + std::to_string(d) + ")";
+        CyclicMatrix views_g, views_h;
+        bch_matrix_views(n, d, views_g, views_h);
+        ok &= check(views_g.get_rows() + views_h.get_rows() == n && views_g.get_cols() == n &&
+                    views_h.get_cols() == n, name + " dimensions");
+        if(n < 256)
+        {
+            ok &= same_as_views(views_g, name + " G");
+            ok &= same_as_views(views_h, name + " H");
+        }
+        // Syndromes of the views vanish on codewords
+        BitMatrix g = materialize(views_g);
+        CyclicWorkspace w;
+        uint64_t swords = (views_h.get_rows() + 63) >> 6;
+        std::vector<uint64_t> cw(g.get_words()), syn(swords);
+        bool zero = true;
+        for(int trial=0; trial<10 && zero; ++trial)
+        {
+            random_codeword(g, cw.data());
+            views_h.mul_transposed(cw.data(), syn.data(), w);
+            for(uint64_t l=0; l<swords; ++l)
+            {
+                zero = zero && syn[l] == 0;
+            }
+        }
+        ok &= check(zero, name + " syndromes of codewords");
+        // A single flipped position is seen
+        cw[0] ^= 1;
+        views_h.mul_transposed(cw.data(), syn.data(), w);
+        bool seen = false;
+        for(uint64_t l=0; l<swords; ++l)
+        {
+            seen = seen || syn[l] != 0;
+        }
+        ok &= check(seen, name + " syndrome of an error");
+    }
+    return ok;
+}
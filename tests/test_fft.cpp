@@ -0,0 +1,37 @@
+#include "tests.h"
+#include "AdditiveFFT.h"
+#include "GF.h"
+
+bool test_fft()
+{
+    /* Evaluation at all 2^m points against Horner, and interpolation back. */
+    bool ok = true;
+    for(uint64_t m=2; m<=10; ++m)
+    {
+        GF2 field(m);
+        AdditiveFFT fft(field);
+        uint64_t points = fft.get_points();
+        std::string name = "FFT over GF(2^" + std::to_string(m) + ")";
+        for(uint64_t len=1; len<=points; len<<=1)
+        {
+            std::vector<uint64_t> coeffs(len), values(points), scratch(points);
+            for(uint64_t i=0; i<len; ++i)
+            {
+                coeffs[i] = rng() & (points - 1);
+            }
+            GF2X f(field, coeffs);
+            std::vector<uint64_t> work(coeffs);
+            fft.evaluate(work.data(), len, values.data(), scratch.data());
+            for(uint64_t x=0; x<points; ++x)
+            {
+                ok &= check(values[x] == f.eval(x), name + " evaluation");
+            }
+            fft.interpolate(values.data(), scratch.data());
+            for(uint64_t i=0; i<points; ++i)
+            {
+                ok &= check(values[i] == (i < len ? coeffs[i] : 0), name + " interpolation");
+            }
+        }
+    }
+    return ok;
+}
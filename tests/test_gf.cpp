@@ -0,0 +1,46 @@
+#include "tests.h"
+#include "GF.h"
+
+static uint64_t clmul_mod(uint64_t a, uint64_t b, uint64_t m)
+{
+    /* Reference product in GF(2^m): shift-and-add with reduction after every shift. */
+    uint64_t poly = PRIMITIVE_POLYS[m];
+    uint64_t ans = 0;
+    for(uint64_t i=0; i<m; ++i)
+    {
+        if((b >> i) & 1)
+        {
+            ans ^= a;
+        }
+        a <<= 1;
+        if((a >> m) & 1)
+        {
+            a ^= poly;
+        }
+    }
+    return ans;
+}
+
+bool test_gf()
+{
+    /* Products, inverses and logarithms with and without the log tables, up to m = 32. */
+    bool ok = true;
+    for(uint64_t m=2; m<=32; m+=(m < 16 ? 3 : 5))
+    {
+        GF2 field(m);
+        std::string name = "GF(2^" + std::to_string(m) + ")";
+        uint64_t mask = (uint64_t(1) << m) - 1;
+        for(int i=0; i<200; ++i)
+        {
+            uint64_t a = rng() & mask, b = rng() & mask;
+            ok &= check(field.mul(a, b) == clmul_mod(a, b, m), name + " mul");
+            if(a != 0)
+            {
+                ok &= check(field.mul(a, field.inv(a)) == 1, name + " inv");
+                uint64_t lg = field.get_elem_deg(a);
+                ok &= check(field.pow(2, int(lg)) == a, name + " log");
+            }
+        }
+    }
+    return ok;
+}
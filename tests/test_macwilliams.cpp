@@ -0,0 +1,26 @@
+#include "tests.h"
+#include "BCHCodes.h"
+#include "WeightDistribution.h"
+
+bool test_macwilliams()
+{
+    /* Spectrum of the code through the smaller dual against direct enumeration. */
+    bool ok = true;
+    uint64_t codes[][2] = {{31, 5}, {31, 7}, {31, 9}};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        BitMatrix g, h;
+        bch_matrices_bit_order(codes[c][0], codes[c][1], g, h);
+        std::string name = "EBCH(" + std::to_string(g.get_cols()) + ", " + std::to_string(g.get_rows()) + ")";
+        std::vector<uint64_t> direct = weight_distribution(g);
+        std::vector<BigInt> transformed = macwilliams(weight_distribution(h), h.get_rows());
+        std::vector<BigInt> spectrum = weight_spectrum(g, h);
+        ok &= check(transformed.size() == direct.size() && spectrum.size() == direct.size(), name + " spectrum length");
+        for(uint64_t w=0; w<direct.size() && ok; ++w)
+        {
+            ok &= check(transformed[w] == BigInt::from_unsigned(direct[w]), name + " MacWilliams transform");
+            ok &= check(spectrum[w] == BigInt::from_unsigned(direct[w]), name + " weight spectrum");
+        }
+    }
+    return ok;
+}
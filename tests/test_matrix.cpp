@@ -0,0 +1,97 @@
+#include <cstring>
+#include "tests.h"
+#include "BCHCodes.h"
+
+static void random_matrix(BitMatrix& a, uint64_t rows, uint64_t cols)
+{
+    a.resize(rows, cols);
+    for(uint64_t i=0; i<rows; ++i)
+    {
+        for(uint64_t j=0; j<cols; ++j)
+        {
+            a.set(i, j, int(rng() & 1));
+        }
+    }
+}
+
+bool test_matrix()
+{
+    /*
+     * M4RM products against the definition: inner sizes with a partial last byte,
+     * fewer than M4RM_WORDS words of output, row counts off the M4RM_ROWS tiles,
+     * one and several threads.
+     */
+    bool ok = true;
+    uint64_t sizes[][3] = {{1, 1, 1}, {5, 13, 7}, {70, 129, 65}, {1100, 67, 130}, {2050, 200, 600}, {300, 64, 1000}};
+    for(uint64_t c=0; c<sizeof(sizes)/sizeof(sizes[0]); ++c)
+    {
+        uint64_t rows = sizes[c][0], inner = sizes[c][1], cols = sizes[c][2];
+        std::string name = std::to_string(rows) + " x " + std::to_string(inner) + " x " + std::to_string(cols);
+        BitMatrix a, b, expected(rows, cols);
+        random_matrix(a, rows, inner);
+        random_matrix(b, inner, cols);
+        for(uint64_t i=0; i<rows; ++i)
+        {
+            for(uint64_t l=0; l<inner; ++l)
+            {
+                if(a.get(i, l))
+                {
+                    for(uint64_t w=0; w<b.get_words(); ++w)
+                    {
+                        expected.row(i)[w] ^= b.row(l)[w];
+                    }
+                }
+            }
+        }
+        for(unsigned threads=1; threads<=4; threads+=3)
+        {
+            BitMatrix prod, t;
+            ok &= check(multiply(a, b, prod, threads), "multiply " + name);
+            bool same = prod.get_rows() == rows && prod.get_cols() == cols;
+            for(uint64_t i=0; i<rows && same; ++i)
+            {
+                same = memcmp(prod.row(i), expected.row(i), sizeof(uint64_t)*prod.get_words()) == 0;
+            }
+            ok &= check(same, "product " + name + ", " + std::to_string(threads) + " threads");
+            transpose(a, t, threads);
+            same = t.get_rows() == inner && t.get_cols() == rows;
+            for(uint64_t i=0; i<rows && same; ++i)
+            {
+                for(uint64_t l=0; l<inner; ++l)
+                {
+                    same = same && t.get(l, i) == a.get(i, l);
+                }
+            }
+            ok &= check(same, "transpose " + name + ", " + std::to_string(threads) + " threads");
+        }
+    }
+    BitMatrix a, b, c(3, 3);
+    random_matrix(a, 4, 5);
+    random_matrix(b, 6, 7);
+    ok &= check(!multiply(a, b, c) && c.get_rows() == 0 && c.get_cols() == 0, "mismatched product is empty");
+    // A single wrong bit of H is noticed
+    BitMatrix g, h;
+    bch_matrices_bit_order(255, 9, g, h);
+    ok &= check(is_orthogonal(g, h, 2), "G H^T = 0");
+    h.flip(h.get_rows() / 2, 100);
+    ok &= check(!is_orthogonal(g, h, 2), "G H^T != 0");
+    // Fixed seeds: the answer depends on the matrices only, on any number of threads
+    bool same = true;
+    for(uint64_t seed=1; seed<=8; ++seed)
+    {
+        same = same && !is_orthogonal(g, h, 1, seed) && !is_orthogonal(g, h, 4, seed);
+    }
+    ok &= check(same, "G H^T != 0 for every seed");
+    // 1 + x + x^3 divides x^7 + 1 but not x^15 + 1
+    std::vector<uint64_t> gen(1, 11);
+    ok &= check(cyclic_matrices_systematic(7, gen, true, g, h), "generator dividing x^n + 1");
+    ok &= check(!cyclic_matrices_systematic(15, gen, false, g, h), "generator not dividing x^n + 1");
+    // Systematic matrices pass the G H^T check after the divisibility one, on any number of threads
+    ok &= check(bch_matrices_systematic(1023, 41, true, g, h, true, 1) &&
+                bch_matrices_systematic(1023, 41, false, g, h, true, 4), "systematic BCH(1023, d = 41) verified");
+    ok &= check(is_orthogonal(g, h, 2), "systematic G H^T = 0");
+    uint64_t emitted = 0;
+    ok &= check(bch_sweep_systematic(255, true, gen, g, h, [&](uint64_t) { ++emitted; }, true, 3) && emitted > 0,
+                "verified sweep of length 255");
+    return ok;
+}
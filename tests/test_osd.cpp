@@ -0,0 +1,25 @@
+#include "tests.h"
+#include "BCHCodes.h"
+#include "OSDDecoder.h"
+
+bool test_osd()
+{
+    /* Up to 7 weak errors on the least reliable positions, orders 1 to 3. */
+    bool ok = true;
+    BitMatrix g, h;
+    bch_matrices_bit_order(63, 11, g, h);
+    for(int order=1; order<=3; ++order)
+    {
+        OSDDecoder osd(g, order, 11);
+        std::vector<uint64_t> cw(g.get_words()), out(g.get_words());
+        std::vector<float> llr(g.get_cols());
+        for(int trial=0; trial<30; ++trial)
+        {
+            random_codeword(g, cw.data());
+            to_llr(cw.data(), g.get_cols(), random_positions(g.get_cols(), rng() % 8), llr.data());
+            osd.decode(llr.data(), out.data());
+            ok &= check(out == cw, "OSD order " + std::to_string(order) + " codeword");
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include "tests.h"
+#include "ReedMullerCodes.h"
+
+bool test_rm()
+{
+    /* Noiseless words and single weak errors come back through the Plotkin decoder. */
+    bool ok = true;
+    int params[][2] = {{1, 5}, {2, 6}, {3, 8}};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        RMCoder rm(params[c][0], params[c][1]);
+        uint64_t n = rm.get_n(), k = rm.get_k();
+        ok &= check(k == rm_dimension(params[c][0], params[c][1]), "RM dimension");
+        std::vector<uint64_t> msg((k + 63) / 64 + 1), cw((n + 63) / 64), out_msg(msg.size()), out_cw(cw.size());
+        std::vector<float> llr(n);
+        for(int trial=0; trial<30; ++trial)
+        {
+            std::fill(msg.begin(), msg.end(), 0);
+            for(uint64_t i=0; i<k; ++i)
+            {
+                msg[i >> 6] |= (rng() & 1) << (i & 63);
+            }
+            rm.encode(msg.data(), cw.data());
+            to_llr(cw.data(), n, random_positions(n, trial % 2), llr.data());
+            std::fill(out_msg.begin(), out_msg.end(), 0);
+            rm.decode(llr.data(), out_msg.data(), out_cw.data());
+            ok &= check(out_msg == msg && out_cw == cw, "RM(" + std::to_string(params[c][0]) + ", " +
+                                                        std::to_string(params[c][1]) + ") round trip");
+        }
+    }
+    return ok;
+}
+
+bool test_rm_invalid()
+{
+    /* Invalid r and m are clamped to a usable code instead of sizing tables from them. */
+    bool ok = true;
+    int params[][4] = {{5, 3, 3, 3}, {-1, 4, 0, 4}, {0, 0, 0, 1}, {2, -3, 1, 1}};
+    for(uint64_t c=0; c<4; ++c)
+    {
+        RMCoder rm(params[c][0], params[c][1]);
+        int r = params[c][2], m = params[c][3];
+        std::string name = "RM(" + std::to_string(params[c][0]) + ", " + std::to_string(params[c][1]) + ")";
+        ok &= check(rm.get_n() == (uint64_t(1) << m) && rm.get_k() == rm_dimension(r, m), name + " is clamped");
+        std::vector<uint64_t> msg(2, 0), cw(1, 0), out_msg(2, 0), out_cw(1, 0);
+        msg[0] = rng() & ((uint64_t(1) << rm.get_k()) - 1);
+        rm.encode(msg.data(), cw.data());
+        std::vector<uint64_t> none;
+        std::vector<float> llr(rm.get_n());
+        to_llr(cw.data(), rm.get_n(), none, llr.data());
+        rm.decode(llr.data(), out_msg.data(), out_cw.data());
+        ok &= check(out_msg == msg && out_cw == cw, name + " round trip");
+    }
+    return ok;
+}
@@ -0,0 +1,75 @@
+#include "tests.h"
+#include "ReedSolomonCodes.h"
+
+bool test_rs()
+{
+    /* Errors and erasures with 2 errors + erasures <= n - k, on the full and a shortened code. */
+    bool ok = true;
+    uint64_t params[][3] = {{255, 223, 8}, {100, 80, 8}, {1000, 900, 10}};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        RSCoder rs(params[c][0], params[c][1], params[c][2]);
+        uint64_t n = rs.get_n(), k = rs.get_k();
+        uint64_t mask = (uint64_t(1) << params[c][2]) - 1;
+        std::string name = "RS(" + std::to_string(n) + ", " + std::to_string(k) + ")";
+        ok &= check(rs.is_valid(), name + " is valid");
+        std::vector<uint16_t> cw(n), word(n);
+        for(int trial=0; trial<50; ++trial)
+        {
+            for(uint64_t i=0; i<k; ++i)
+            {
+                cw[i] = uint16_t(rng() & mask);
+            }
+            rs.encode(cw.data(), cw.data() + k);
+            word = cw;
+            uint64_t erased = rng() % (n - k + 1);
+            uint64_t wrong = (n - k - erased) / 2;
+            std::vector<uint64_t> pos = random_positions(n, erased + wrong);
+            for(uint64_t i=0; i<pos.size(); ++i)
+            {
+                word[pos[i]] ^= uint16_t(1 + rng() % mask);
+            }
+            int count = rs.decode(word.data(), pos.data(), erased);
+            ok &= check(count >= 0 && word == cw, name + " errors and erasures");
+        }
+    }
+    return ok;
+}
+
+bool test_rs_invalid()
+{
+    /* Bad parameters give an invalid coder, bad erasure lists fail without touching the word. */
+    bool ok = true;
+    uint64_t params[][3] = {{255, 255, 8}, {255, 0, 8}, {300, 200, 8}, {15, 5, 1}, {15, 5, 17}};
+    for(uint64_t c=0; c<5; ++c)
+    {
+        RSCoder rs(params[c][0], params[c][1], params[c][2]);
+        std::vector<uint16_t> word(params[c][0] + 1, 1);
+        ok &= check(!rs.is_valid() && rs.decode(word.data()) == -1, "RS(" + std::to_string(params[c][0]) + ", " +
+                    std::to_string(params[c][1]) + ") over GF(2^" + std::to_string(params[c][2]) + ") is invalid");
+    }
+    RSCoder rs(63, 51, 6);
+    std::vector<uint16_t> cw(63, 0);
+    for(uint64_t i=0; i<51; ++i)
+    {
+        cw[i] = uint16_t(rng() & 63);
+    }
+    rs.encode(cw.data(), cw.data() + 51);
+    std::vector<uint16_t> word(cw);
+    word[3] ^= 5;
+    uint64_t out_of_range[] = {3, 63};
+    uint64_t repeated[] = {3, 7, 3};
+    uint64_t too_many[13];
+    for(uint64_t i=0; i<13; ++i)
+    {
+        too_many[i] = i;
+    }
+    ok &= check(rs.decode(word.data(), out_of_range, 2) == -1, "erasure past the code");
+    ok &= check(rs.decode(word.data(), repeated, 3) == -1, "repeated erasure");
+    ok &= check(rs.decode(word.data(), too_many, 13) == -1, "more erasures than n - k");
+    ok &= check(word[3] == (cw[3] ^ 5), "word is kept on invalid erasures");
+    // The rejected lists leave no state behind
+    uint64_t valid[] = {3, 7};
+    ok &= check(rs.decode(word.data(), valid, 2) >= 0 && word == cw, "erasures after rejected lists");
+    return ok;
+}
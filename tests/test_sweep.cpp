@@ -0,0 +1,150 @@
+#include <algorithm>
+#include "tests.h"
+#include "bchcodes_api.h"
+#include "BCHCodes.h"
+#include "BCHDecoder.h"
+
+struct SweepCheck {
+    int layout;
+    uint64_t last_d;
+    uint64_t codes;
+    bool ok;
+};
+
+static std::vector<uint64_t> matrices(const bch_code* code)
+{
+    /* G and H one after another. */
+    uint64_t words = bch_code_words(code);
+    std::vector<uint64_t> ans((bch_code_dimension(code) + bch_code_check_rows(code))*words);
+    bch_code_get_generator(code, ans.data());
+    bch_code_get_check(code, ans.data() + bch_code_dimension(code)*words);
+    return ans;
+}
+
+static void compare_code(bch_code* code, uint64_t d, void* context)
+{
+    /*
+     * The swept code equals the one bch_code_create builds for d, d is the
+     * largest distance giving it, and the shared decoder corrects like a fresh one.
+     */
+    SweepCheck* c = static_cast<SweepCheck*>(context);
+    uint64_t n = bch_code_length(code) - (c->layout == BCH_LAYOUT_SYSTEMATIC_EXTENDED ? 1 : 0);
+    std::string name = "sweep of length " + std::to_string(n) + ", d = " + std::to_string(d);
+    c->ok &= check(d > c->last_d, name + " distances increase");
+    c->last_d = d;
+    ++c->codes;
+    bch_code* fresh = bch_code_create(n, d, c->layout);
+    c->ok &= check(fresh != nullptr, name + " is created");
+    if(fresh == nullptr)
+    {
+        return;
+    }
+    c->ok &= check(bch_code_dimension(fresh) == bch_code_dimension(code) && matrices(fresh) == matrices(code),
+                   name + " matches bch_code_create");
+    if(d + 2 <= n)
+    {
+        bch_code* next = bch_code_create(n, d + 2, c->layout);
+        c->ok &= check(next != nullptr && bch_code_dimension(next) < bch_code_dimension(code),
+                       name + " is the largest distance of its code");
+        bch_code_destroy(next);
+    }
+    uint64_t k = bch_code_dimension(code), words = bch_code_words(code), len = bch_code_length(code);
+    std::vector<uint64_t> msg((k + 63) / 64 + 1), cw(words), word(words), word2(words);
+    for(int trial=0; trial<10; ++trial)
+    {
+        std::fill(msg.begin(), msg.end(), 0);
+        for(uint64_t i=0; i<k; ++i)
+        {
+            msg[i >> 6] |= (rng() & 1) << (i & 63);
+        }
+        bch_code_encode(code, msg.data(), cw.data());
+        word = cw;
+        // Beyond t as well, then both decoders must fail or agree
+        std::vector<uint64_t> errors = random_positions(len, rng() % ((d - 1) / 2 + 3));
+        for(uint64_t i=0; i<errors.size(); ++i)
+        {
+            word[errors[i] >> 6] ^= uint64_t(1) << (errors[i] & 63);
+        }
+        word2 = word;
+        int count = bch_code_decode(code, word.data());
+        c->ok &= check(count == bch_code_decode(fresh, word2.data()) && word == word2, name + " decodes as a fresh decoder");
+        if(2*errors.size() < d)
+        {
+            c->ok &= check(count == int(errors.size()) && word == cw, name + " round trip");
+        }
+    }
+    bch_code_destroy(fresh);
+}
+
+bool test_sweep()
+{
+    /* Every code of the sweep against bch_code_create, both systematic layouts. */
+    bool ok = true;
+    uint64_t lengths[] = {15, 63, 255};
+    int layouts[] = {BCH_LAYOUT_SYSTEMATIC, BCH_LAYOUT_SYSTEMATIC_EXTENDED};
+    for(uint64_t i=0; i<3; ++i)
+    {
+        for(int l=0; l<2; ++l)
+        {
+            SweepCheck c = {layouts[l], 0, 0, true};
+            int64_t count = bch_code_sweep(lengths[i], layouts[l], compare_code, &c);
+            ok &= c.ok;
+            ok &= check(count > 0 && uint64_t(count) == c.codes, "sweep of length " + std::to_string(lengths[i]) +
+                        " reports its codes");
+        }
+    }
+    return ok;
+}
+
+bool test_set_distance()
+{
+    /*
+     * A decoder moved through distances up and down decodes like a fresh one,
+     * and a ChaseDecoder built on it before the switch follows the new t.
+     */
+    bool ok = true;
+    uint64_t n = 255;
+    BCHDecoder shared(n, 5, true);
+    ChaseDecoder chase(shared, 3);
+    uint64_t distances[] = {5, 21, 9, 61, 3, 121};
+    for(uint64_t c=0; c<sizeof(distances)/sizeof(distances[0]); ++c)
+    {
+        uint64_t d = distances[c];
+        std::string name = "set_distance(" + std::to_string(d) + ")";
+        shared.set_distance(d);
+        BCHDecoder fresh(n, d, true);
+        ok &= check(shared.get_t() == fresh.get_t(), name + " t");
+        BitMatrix g, h;
+        bch_matrices_bit_order(n, d, g, h);
+        std::vector<uint64_t> cw(g.get_words());
+        std::vector<uint8_t> word(n + 1), word2(n + 1), out(n + 1);
+        std::vector<float> llr(n + 1);
+        for(int trial=0; trial<20; ++trial)
+        {
+            random_codeword(g, cw.data());
+            std::vector<uint64_t> errors = random_positions(n + 1, rng() % (fresh.get_t() + 3));
+            for(uint64_t p=0; p<=n; ++p)
+            {
+                word[p] = uint8_t((cw[p >> 6] >> (p & 63)) & 1);
+            }
+            to_llr(cw.data(), n + 1, errors, llr.data());
+            for(uint64_t i=0; i<errors.size(); ++i)
+            {
+                word[errors[i]] ^= 1;
+            }
+            word2 = word;
+            ok &= check(shared.decode(word.data()) == fresh.decode(word2.data()) && word == word2, name + " decodes");
+            if(errors.size() <= fresh.get_t() + 1)
+            {
+                ok &= check(chase.decode(llr.data(), out.data()) >= 0, name + " Chase decodes");
+                bool same = true;
+                for(uint64_t p=0; p<=n; ++p)
+                {
+                    same = same && out[p] == ((cw[p >> 6] >> (p & 63)) & 1);
+                }
+                ok &= check(same, name + " Chase codeword");
+            }
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "tests.h"
+#include "BCHCodes.h"
+#include "SyndromeTable.h"
+
+static bool table_round_trip(const SyndromeTable& table, const BitMatrix& g, uint64_t t, const std::string& name)
+{
+    /* Up to t errors are corrected in place and counted. */
+    bool ok = true;
+    std::vector<uint64_t> cw(g.get_words()), word(g.get_words());
+    for(int trial=0; trial<100 && ok; ++trial)
+    {
+        random_codeword(g, cw.data());
+        word = cw;
+        std::vector<uint64_t> errors = random_positions(g.get_cols(), rng() % (t + 1));
+        for(uint64_t i=0; i<errors.size(); ++i)
+        {
+            word[errors[i] >> 6] ^= uint64_t(1) << (errors[i] & 63);
+        }
+        ok &= check(table.decode(word.data()) == int(errors.size()) && word == cw, name);
+    }
+    return ok;
+}
+
+static void write_file(const char* path, const std::vector<char>& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+bool test_syndrome_table()
+{
+    /* Built in memory, then saved and mapped back with and without the expected code. */
+    bool ok = true;
+    BitMatrix g, h;
+    bch_matrices_systematic(63, 7, false, g, h);
+    SyndromeTable table(h, 3, 2);
+    ok &= check(table.is_valid(), "syndrome table is built");
+    ok &= table_round_trip(table, g, 3, "syndrome table decoding");
+    const char* path = "syndrome_table.bin";
+    ok &= check(table.save(path), "syndrome table is saved");
+    SyndromeTable mapped(path);
+    ok &= check(mapped.is_valid(), "syndrome table is mapped");
+    ok &= table_round_trip(mapped, g, 3, "mapped syndrome table decoding");
+    SyndromeTable matched(path, &h);
+    ok &= check(matched.is_valid(), "mapped table matches its code");
+    std::remove(path);
+    return ok;
+}
+
+bool test_syndrome_table_invalid()
+{
+    /* Truncated, padded, foreign and inconsistent files are refused before any entry is read. */
+    bool ok = true;
+    BitMatrix g, h, g2, h2;
+    bch_matrices_systematic(31, 5, false, g, h);
+    bch_matrices_systematic(31, 7, false, g2, h2);
+    const char* path = "syndrome_table_invalid.bin";
+    SyndromeTable table(h, 2);
+    table.save(path);
+    std::vector<char> data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    ok &= check(!data.empty(), "saved table is read back");
+    std::vector<char> truncated(data.begin(), data.end() - 2), padded(data);
+    padded.push_back(0);
+    write_file(path, truncated);
+    ok &= check(!SyndromeTable(path).is_valid(), "truncated table is refused");
+    write_file(path, padded);
+    ok &= check(!SyndromeTable(path).is_valid(), "padded table is refused");
+    write_file(path, data);
+    ok &= check(!SyndromeTable(path, &h2).is_valid(), "table of another code is refused");
+    BitMatrix other(h);
+    other.flip(0, 20);
+    ok &= check(!SyndromeTable(path, &other).is_valid(), "table of another check matrix is refused");
+    // Header words: magic, n, r, t
+    uint64_t headers[][3] = {{31, 10, 0}, {31, 10, 32}, {31, 0, 2}, {31, 40, 2}, {70000, 10, 2}, {31, 25, 2}};
+    for(uint64_t c=0; c<6; ++c)
+    {
+        std::vector<char> bad(data);
+        memcpy(bad.data() + 8, headers[c], sizeof(headers[c]));
+        write_file(path, bad);
+        ok &= check(!SyndromeTable(path).is_valid(), "header " + std::to_string(headers[c][0]) + ", " +
+                    std::to_string(headers[c][1]) + ", " + std::to_string(headers[c][2]) + " is refused");
+    }
+    // A position past the code in an otherwise valid file is not applied
+    std::vector<char> foreign(data);
+    std::vector<uint64_t> cw(g.get_words());
+    random_codeword(g, cw.data());
+    cw[0] ^= 1;
+    uint64_t syn = table.syndrome(cw.data());
+    uint64_t offset = (4 + h.get_rows()*h.get_words())*sizeof(uint64_t) + syn*2*sizeof(uint16_t);
+    uint16_t bad_pos = 40;
+    memcpy(foreign.data() + offset, &bad_pos, sizeof(bad_pos));
+    write_file(path, foreign);
+    SyndromeTable mapped(path);
+    std::vector<uint64_t> word(cw);
+    ok &= check(mapped.is_valid() && mapped.decode(word.data()) == -1 && word == cw, "position past the code");
+    std::remove(path);
+    return ok;
+}
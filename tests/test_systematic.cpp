@@ -0,0 +1,87 @@
+#include "tests.h"
+#include "BCHCodes.h"
+#include "GF.h"
+#include "WeightDistribution.h"
+
+static bool orthogonal(const BitMatrix& g, const BitMatrix& h)
+{
+    /* G H^T = 0 by plain dot products. */
+    for(uint64_t i=0; i<g.get_rows(); ++i)
+    {
+        for(uint64_t j=0; j<h.get_rows(); ++j)
+        {
+            uint64_t acc = 0;
+            for(uint64_t w=0; w<g.get_words(); ++w)
+            {
+                acc ^= g.row(i)[w] & h.row(j)[w];
+            }
+            if(__builtin_popcountll(acc) & 1)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool test_systematic()
+{
+    /*
+     * Systematic matrices have the shape G = [P | I], H = [I | P^T] (plus the
+     * parity column and row when extended) and are orthogonal. The extended
+     * systematic code is the bit order code with its columns permuted: column j
+     * is the locator alpha^j, column n the locator 0. So permuted rows of G pass
+     * the bit order H, and both have the same weight spectrum.
+     */
+    bool ok = true;
+    uint64_t codes[][2] = {{31, 5}, {63, 21}, {255, 29}, {1023, 101}};
+    for(uint64_t c=0; c<sizeof(codes)/sizeof(codes[0]); ++c)
+    {
+        uint64_t n = codes[c][0], d = codes[c][1];
+        std::string name = "BCH(" + std::to_string(n) + ", d = " + std::to_string(d) + ")";
+        BitMatrix g, h, eg, eh, bg, bh;
+        ok &= check(bch_matrices_systematic(n, d, false, g, h), name + " systematic");
+        ok &= check(bch_matrices_systematic(n, d, true, eg, eh), name + " extended systematic");
+        bch_matrices_bit_order(n, d, bg, bh);
+        uint64_t k = g.get_rows(), r = n - k;
+        bool shape = h.get_rows() == r && eg.get_rows() == k && eh.get_rows() == r + 1 && bg.get_rows() == k;
+        for(uint64_t i=0; i<k && shape; ++i)
+        {
+            for(uint64_t j=0; j<k; ++j)
+            {
+                shape = shape && g.get(i, r + j) == int(i == j);
+            }
+            for(uint64_t j=0; j<r; ++j)
+            {
+                shape = shape && h.get(j, r + i) == g.get(i, j);
+            }
+        }
+        for(uint64_t j=0; j<r && shape; ++j)
+        {
+            for(uint64_t l=0; l<r; ++l)
+            {
+                shape = shape && h.get(j, l) == int(j == l);
+            }
+        }
+        ok &= check(shape, name + " systematic shape");
+        ok &= check(orthogonal(g, h) && orthogonal(eg, eh), name + " G H^T = 0");
+        GF2 field(__builtin_ctzll(n + 1));
+        BitMatrix permuted(k, n + 1);
+        for(uint64_t i=0; i<k; ++i)
+        {
+            uint64_t x = 1;
+            for(uint64_t j=0; j<n; ++j)
+            {
+                permuted.set(i, x, eg.get(i, j));
+                x = field.mul(x, 2);
+            }
+            permuted.set(i, 0, eg.get(i, n));
+        }
+        ok &= check(orthogonal(permuted, bh), name + " permuted extended code is the bit order code");
+        if(k <= 24 || n + 1 - k <= 24)
+        {
+            ok &= check(weight_spectrum(eg, eh) == weight_spectrum(bg, bh), name + " weight spectra");
+        }
+    }
+    return ok;
+}
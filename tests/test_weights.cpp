@@ -0,0 +1,54 @@
+#include "tests.h"
+#include "BCHCodes.h"
+#include "WeightDistribution.h"
+
+static std::vector<uint64_t> naive_distribution(const BitMatrix& g)
+{
+    /* Weights of all 2^k messages one by one. */
+    std::vector<uint64_t> ans(g.get_cols() + 1, 0);
+    std::vector<uint64_t> cw(g.get_words());
+    for(uint64_t msg=0; msg < (uint64_t(1) << g.get_rows()); ++msg)
+    {
+        std::fill(cw.begin(), cw.end(), 0);
+        uint64_t weight = 0;
+        for(uint64_t i=0; i<g.get_rows(); ++i)
+        {
+            if((msg >> i) & 1)
+            {
+                for(uint64_t w=0; w<g.get_words(); ++w)
+                {
+                    cw[w] ^= g.row(i)[w];
+                }
+            }
+        }
+        for(uint64_t w=0; w<g.get_words(); ++w)
+        {
+            weight += __builtin_popcountll(cw[w]);
+        }
+        ++ans[weight];
+    }
+    return ans;
+}
+
+bool test_weights()
+{
+    /* Gray code enumeration on 1 and 4 threads against the naive one, and the true minimum distance. */
+    bool ok = true;
+    uint64_t codes[][2] = {{31, 7}, {63, 21}, {127, 49}};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        BitMatrix g, h;
+        bch_matrices_bit_order(codes[c][0], codes[c][1], g, h);
+        std::string name = "EBCH(" + std::to_string(g.get_cols()) + ", " + std::to_string(g.get_rows()) + ")";
+        std::vector<uint64_t> expected = naive_distribution(g);
+        ok &= check(weight_distribution(g, 1) == expected, name + " weights on one thread");
+        ok &= check(weight_distribution(g, 4) == expected, name + " weights on four threads");
+        uint64_t dmin = 1;
+        while(dmin < expected.size() && expected[dmin] == 0)
+        {
+            ++dmin;
+        }
+        ok &= check(minimum_distance(g, 4) == dmin, name + " minimum distance");
+    }
+    return ok;
+}
@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include "tests.h"
+#include "AsyncWriter.h"
+
+static std::string format_rows(const BitMatrix& a)
+{
+    /* Reference formatting: "b b ... b \n" per row. */
+    std::string ans;
+    for(uint64_t i=0; i<a.get_rows(); ++i)
+    {
+        for(uint64_t j=0; j<a.get_cols(); ++j)
+        {
+            ans += char('0' + a.get(i, j));
+            ans += ' ';
+        }
+        ans += '\n';
+    }
+    return ans;
+}
+
+static std::string read_file(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void write_matrices(AsyncWriter& writer, const std::vector<BitMatrix>& parts)
+{
+    for(uint64_t i=0; i<parts.size(); ++i)
+    {
+        writer.text("part " + std::to_string(i) + "\n");
+        writer.rows(parts[i]);
+    }
+}
+
+bool test_writer()
+{
+    /*
+     * The same text through every sink: ostream and descriptor, with and without
+     * the thread, rings of one and two tiny slots so both sides keep sleeping,
+     * a file with O_DIRECT whose size is not a multiple of the block, and more
+     * text than the stage holds.
+     */
+    bool ok = true;
+    std::vector<BitMatrix> parts(4);
+    uint64_t sizes[][2] = {{3, 5}, {700, 130}, {1, 64}, {2000, 333}};
+    std::string expected;
+    for(uint64_t i=0; i<4; ++i)
+    {
+        parts[i].resize(sizes[i][0], sizes[i][1]);
+        for(uint64_t r=0; r<sizes[i][0]; ++r)
+        {
+            for(uint64_t c=0; c<sizes[i][1]; ++c)
+            {
+                parts[i].set(r, c, int(rng() & 1));
+            }
+        }
+        expected += "part " + std::to_string(i) + "\n" + format_rows(parts[i]);
+    }
+    ok &= check(expected.size() > (uint64_t(1) << 20) && expected.size() % 4096 != 0, "output spans the stage");
+    uint64_t rings[][2] = {{8, 1 << 16}, {1, 1}, {2, 3}};
+    for(uint64_t c=0; c<3; ++c)
+    {
+        std::string name = "ring of " + std::to_string(rings[c][0]) + " x " + std::to_string(rings[c][1]) + " words";
+        for(int threaded=0; threaded<2; ++threaded)
+        {
+            std::ostringstream out;
+            AsyncWriter writer(out, threaded != 0, rings[c][0], rings[c][1]);
+            write_matrices(writer, parts);
+            ok &= check(writer.finish() && out.str() == expected, name + " to a stream, threaded = " +
+                        std::to_string(threaded));
+        }
+        const char* path = "writer_test.txt";
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        {
+            AsyncWriter writer(fd, true, rings[c][0], rings[c][1]);
+            write_matrices(writer, parts);
+            ok &= check(writer.finish(), name + " to a descriptor finishes");
+        }
+        close(fd);
+        ok &= check(read_file(path) == expected, name + " to a descriptor");
+        for(int direct=0; direct<2; ++direct)
+        {
+            AsyncWriter writer(path, direct != 0, true, rings[c][0], rings[c][1]);
+            write_matrices(writer, parts);
+            ok &= check(writer.finish(), name + " to a file finishes, direct = " + std::to_string(direct));
+            ok &= check(read_file(path) == expected, name + " to a file, direct = " + std::to_string(direct));
+        }
+        std::remove(path);
+    }
+    return ok;
+}
+
+bool test_writer_failure()
+{
+    /* Failed sinks are reported by finish(), which can be called again, and later output is dropped. */
+    bool ok = true;
+    BitMatrix a(100, 100);
+    {
+        AsyncWriter writer("no_such_directory/out.txt", false);
+        writer.rows(a);
+        ok &= check(!writer.finish() && !writer.finish(), "file that can't be opened");
+    }
+    {
+        AsyncWriter writer(-1, true);
+        writer.rows(a);
+        ok &= check(!writer.finish(), "invalid descriptor");
+    }
+    for(int threaded=0; threaded<2; ++threaded)
+    {
+        std::ostream bad(nullptr);
+        AsyncWriter writer(bad, threaded != 0);
+        writer.text("lost\n");
+        writer.rows(a);
+        ok &= check(!writer.finish(), "stream in a failed state, threaded = " + std::to_string(threaded));
+    }
+    int fd = open("/dev/full", O_WRONLY);
+    if(fd >= 0)
+    {
+        {
+            AsyncWriter writer(fd, true, 2, 4);
+            for(int i=0; i<50; ++i)
+            {
+                writer.rows(a);
+            }
+            ok &= check(!writer.finish(), "device without space");
+        }
+        close(fd);
+    }
+    return ok;
+}
@@ -0,0 +1,46 @@
+#ifndef BCHCODES_TESTS_TESTS_H_
+#define BCHCODES_TESTS_TESTS_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "BitMatrix.h"
+
+/*
+ * Helpers shared by the tests. Every test is a function returning false on a
+ * failure, run by bchcodes_tests under its name; ctest runs each one separately.
+ */
+
+extern std::mt19937_64 rng; // Fixed seed, failures replay
+
+bool check(bool ok, const std::string& what);
+void random_codeword(const BitMatrix& g, uint64_t* word);
+std::vector<uint64_t> random_positions(uint64_t n, uint64_t count);
+void to_llr(const uint64_t* word, uint64_t n, const std::vector<uint64_t>& errors, float* llr);
+
+bool test_rm();
+bool test_rm_invalid();
+bool test_rs();
+bool test_rs_invalid();
+bool test_bch();
+bool test_chase();
+bool test_osd();
+bool test_syndrome_table();
+bool test_syndrome_table_invalid();
+bool test_weights();
+bool test_macwilliams();
+bool test_gf();
+bool test_fft();
+bool test_bit_order();
+bool test_systematic();
+bool test_api();
+bool test_sweep();
+bool test_set_distance();
+bool test_writer();
+bool test_writer_failure();
+bool test_bp();
+bool test_cyclic();
+bool test_matrix();
+
+#endif //BCHCODES_TESTS_TESTS_H_